@@ -22,13 +22,14 @@
 #include "object.h"
 #include "ef.h"
 #include "env.h"
-#include "text.h"
+#include "symbol.h"
 #include "core.h"
 #include "num.h"
 #include "str.h"
 #include "var.h"
 #include "bool.h"
 #include "gc.h"
+#include "scope.h"
 #include "assignment.h"
 
 
@@ -105,6 +106,10 @@ CSCM_ASSIGNMENT_EF_STATE *_cscm_assignment_ef_state_create()
 	state->var = NULL;
 	state->val_ef = NULL;
 
+	state->addr = CSCM_SCOPE_ADDR_DYNAMIC;
+	state->depth = 0;
+	state->slot = 0;
+
 
 	return state;
 }
@@ -125,7 +130,13 @@ CSCM_OBJECT *_cscm_assignment_ef(void *state, CSCM_OBJECT *env)
 	 * referenced by the old. */
 	cscm_gc_inc(val);
 
-	cscm_env_set_var(env, s->var, val);
+	if (s->addr == CSCM_SCOPE_ADDR_LOCAL)
+		cscm_env_set_var_at(env, s->depth, s->slot, s->var, val);
+	else if (s->addr == CSCM_SCOPE_ADDR_GLOBAL)
+		cscm_env_set_global_var(env, s->var, val);
+	else
+		cscm_env_set_var(env, s->var, val);
+
 	cscm_gc_dec(val);
 	
 
@@ -149,7 +160,7 @@ CSCM_EF *cscm_analyze_assignment(CSCM_AST_NODE *exp)
 	val = cscm_ast_exp_index(exp, 2);
 
 
-	var_text = cscm_text_cpy(var->text);
+	var_text = cscm_symbol_intern_text(var->text);
 	val_ef = cscm_analyze(val);
 
 
@@ -157,6 +168,10 @@ CSCM_EF *cscm_analyze_assignment(CSCM_AST_NODE *exp)
 	state->var = var_text;
 	state->val_ef = val_ef;
 
+	state->addr = cscm_scope_resolve_assignment(var_text,	\
+						&state->depth,	\
+						&state->slot);
+
 
 	return cscm_ef_construct(CSCM_EF_TYPE_ASSIGNMENT,	\
 				state,				\
@@ -182,8 +197,7 @@ void cscm_assignment_ef_free(CSCM_EF *ef)
 
 	state = (CSCM_ASSIGNMENT_EF_STATE *)ef->state;
 
-	free(state->var);
-	cscm_ef_free_tree(state->val_ef);
+	cscm_ef_free_tree(state->val_ef); // state->var is interned
 
 	free(state);
 
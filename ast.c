@@ -150,7 +150,7 @@ CSCM_AST_NODE *cscm_ast_exp_create(char *filename, size_t line)
 
 	exp->n_childs = 0;
 	exp->pages = (CSCM_AST_NODE ***)cscm_ast_node_ptrs_create( \
-						CSCM_AST_EXP_PAGE_MAX_N);
+						CSCM_AST_EXP_PAGE_INIT_N);
 
 
 	return exp;
@@ -269,6 +269,31 @@ void cscm_ast_symbol_set_simple(CSCM_AST_NODE *symbol, char *text)
 }
 
 
+/*	Allocate page page_n, which is right behind the last page.
+ * The array of pages is full when page_n is CSCM_AST_EXP_PAGE_INIT_N
+ * times a power of 2, see ast.h. */
+void _cscm_ast_exp_add_page(CSCM_AST_NODE *exp, size_t page_n)
+{
+	size_t n;
+	CSCM_AST_NODE ***pages;
+
+
+	n = page_n / CSCM_AST_EXP_PAGE_INIT_N;
+
+	if (page_n % CSCM_AST_EXP_PAGE_INIT_N == 0 && n && !(n & (n - 1))) {
+		pages = realloc(exp->pages,				\
+				2 * page_n * sizeof(CSCM_AST_NODE **));
+		if (pages == NULL)
+			cscm_libc_fail("_cscm_ast_exp_add_page", "realloc");
+
+		exp->pages = pages;
+	}
+
+
+	exp->pages[page_n] = cscm_ast_node_ptrs_create(CSCM_AST_EXP_PAGE_SIZE);
+}
+
+
 /* add a new child node after all existed ones */
 void cscm_ast_exp_append(CSCM_AST_NODE *exp, CSCM_AST_NODE *new_child)
 {
@@ -297,14 +322,8 @@ void cscm_ast_exp_append(CSCM_AST_NODE *exp, CSCM_AST_NODE *new_child)
 	page_index = q.rem;
 
 
-	if (page_n >= CSCM_AST_EXP_PAGE_MAX_N)
-		cscm_error_report("cscm_ast_exp_append", \
-				CSCM_ERROR_AST_FULL_EXP);
-
-
 	if (page_index == 0)
-		exp->pages[page_n] = cscm_ast_node_ptrs_create( \
-						CSCM_AST_EXP_PAGE_SIZE);
+		_cscm_ast_exp_add_page(exp, page_n);
 
 
 	page = exp->pages[page_n];
@@ -422,17 +441,11 @@ void cscm_ast_exp_insert_first(CSCM_AST_NODE *exp, CSCM_AST_NODE *new_child)
 
 	// now the last page is full, and we have to allocate a new one
 	if (page_index == (CSCM_AST_EXP_PAGE_SIZE - 1)) {
-		if ((page_n + 1) == CSCM_AST_EXP_PAGE_MAX_N) {
-			cscm_error_report("cscm_ast_exp_insert_first", \
-					CSCM_ERROR_AST_FULL_EXP);
-		} else {
-			exp->pages[page_n + 1] = cscm_ast_node_ptrs_create( \
-						CSCM_AST_EXP_PAGE_SIZE);
+		_cscm_ast_exp_add_page(exp, page_n + 1);
 
-			next_page = exp->pages[page_n + 1];
+		next_page = exp->pages[page_n + 1];
 
-			next_page[0] = page[CSCM_AST_EXP_PAGE_SIZE - 1];
-		}
+		next_page[0] = page[CSCM_AST_EXP_PAGE_SIZE - 1];
 	}
 
 
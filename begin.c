@@ -124,7 +124,8 @@ CSCM_OBJECT *_cscm_seq_ef(void *state, CSCM_OBJECT *env)
 
 	if (last_clause_ef->type != CSCM_EF_TYPE_COMBINATION	\
 		&& last_clause_ef->type != CSCM_EF_TYPE_IF	\
-		&& last_clause_ef->type != CSCM_EF_TYPE_SEQ)
+		&& last_clause_ef->type != CSCM_EF_TYPE_SEQ	\
+		&& last_clause_ef->type != CSCM_EF_TYPE_LET)
 		cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
 
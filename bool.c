@@ -25,15 +25,6 @@
 
 
 
-/* there is only one copy of true in cscheme */
-CSCM_OBJECT _cscm_bool_true = {CSCM_OBJECT_TYPE_BOOL_TRUE, (void *)0, 0};
-
-/* there is only one copy of false in cscheme */
-CSCM_OBJECT _cscm_bool_false = {CSCM_OBJECT_TYPE_BOOL_FALSE, (void *)0, 0};
-
-
-
-
 void cscm_bool_print(CSCM_OBJECT *obj, FILE *stream)
 {
 	if (obj == NULL || stream == NULL)
@@ -45,8 +36,8 @@ void cscm_bool_print(CSCM_OBJECT *obj, FILE *stream)
 		fputs("#t", stream);
 	else if (obj == CSCM_FALSE)
 		fputs("#f", stream);
-	else if (obj->type == CSCM_OBJECT_TYPE_BOOL_TRUE
-		|| obj->type == CSCM_OBJECT_TYPE_BOOL_FALSE)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_TRUE
+		|| CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_FALSE)
 		cscm_error_report("cscm_bool_print", \
 				CSCM_ERROR_BOOL_EXTRA_COPY);
 	else
@@ -65,11 +56,11 @@ void cscm_bool_free(CSCM_OBJECT *obj)
 
 
 	if (obj == CSCM_TRUE)
-		return; // since it is not stored on the heap
+		return; // since it is an immediate object
 	else if (obj == CSCM_FALSE)
-		return; // since it is not stored on the heap
-	else if (obj->type == CSCM_OBJECT_TYPE_BOOL_TRUE
-		|| obj->type == CSCM_OBJECT_TYPE_BOOL_FALSE)
+		return; // since it is an immediate object
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_TRUE
+		|| CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_FALSE)
 		cscm_error_report("cscm_bool_free", \
 				CSCM_ERROR_BOOL_EXTRA_COPY);
 	else
@@ -31,6 +31,7 @@
 #include "ef.h"
 #include "env.h"
 #include "gc.h"
+#include "proc.h"
 #include "builtin.h"
 #include "builtin_seq.h"
 #include "builtin_symbol.h"
@@ -255,7 +256,7 @@ CSCM_OBJECT *cscm_builtin_proc_set_car(size_t n, CSCM_OBJECT **args)
 	obj = args[1];
 
 
-	if (pair->type != CSCM_OBJECT_TYPE_PAIR)
+	if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_builtin_proc_set_car", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -282,7 +283,7 @@ CSCM_OBJECT *cscm_builtin_proc_set_cdr(size_t n, CSCM_OBJECT **args)
 	obj = args[1];
 
 
-	if (pair->type != CSCM_OBJECT_TYPE_PAIR)
+	if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_builtin_proc_set_cdr", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -330,7 +331,7 @@ CSCM_OBJECT *cscm_builtin_proc_car(size_t n, CSCM_OBJECT **args)
 	pair = args[0];
 
 
-	if (pair->type != CSCM_OBJECT_TYPE_PAIR)
+	if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_builtin_proc_car", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -353,7 +354,7 @@ CSCM_OBJECT *cscm_builtin_proc_cdr(size_t n, CSCM_OBJECT **args)
 	pair = args[0];
 
 
-	if (pair->type != CSCM_OBJECT_TYPE_PAIR)
+	if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_builtin_proc_cdr", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -641,7 +642,7 @@ CSCM_OBJECT *cscm_builtin_proc_add(size_t n, CSCM_OBJECT **args)
 
 	flag_long_ret = 1;
 	for (i = 0; i < n; i++) {
-		if (args[i]->type != CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(args[i]) != CSCM_OBJECT_TYPE_NUM_LONG) {
 			flag_long_ret = 0;
 			break;
 		}
@@ -653,13 +654,12 @@ CSCM_OBJECT *cscm_builtin_proc_add(size_t n, CSCM_OBJECT **args)
 		for (i = 0; i < n; i++)
 			l += cscm_num_long_get(args[i]);
 
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, l);
+		ret = cscm_num_long_create(l);
 	} else {
 		for (i = 0; i < n; i++) {
-			if (args[i]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+			if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_LONG)
 				d += cscm_num_long_get(args[i]);
-			else if (args[i]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+			else if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 				d += cscm_num_double_get(args[i]);
 			else
 				cscm_error_report("cscm_builtin_proc_add", \
@@ -696,12 +696,11 @@ CSCM_OBJECT *cscm_builtin_proc_subtract(size_t n, CSCM_OBJECT **args)
 
 
 	if (n == 1) {
-		if (args[0]->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_LONG) {
 			l = cscm_num_long_get(args[0]);
 
-			ret = cscm_num_long_create();
-			cscm_num_long_set(ret, -l);
-		} else if (args[0]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+			ret = cscm_num_long_create(-l);
+		} else if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 			d = cscm_num_double_get(args[0]);
 
 			ret = cscm_num_double_create();
@@ -718,7 +717,7 @@ CSCM_OBJECT *cscm_builtin_proc_subtract(size_t n, CSCM_OBJECT **args)
 
 	flag_long_ret = 1;
 	for (i = 0; i < n; i++) {
-		if (args[i]->type != CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(args[i]) != CSCM_OBJECT_TYPE_NUM_LONG) {
 			flag_long_ret = 0;
 			break;
 		}
@@ -733,12 +732,11 @@ CSCM_OBJECT *cscm_builtin_proc_subtract(size_t n, CSCM_OBJECT **args)
 			l -= cscm_num_long_get(args[i]);
 
 
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, l);
+		ret = cscm_num_long_create(l);
 	} else {
-		if (args[0]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+		if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_LONG)
 			d = cscm_num_long_get(args[0]);
-		else if (args[0]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+		else if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 			d = cscm_num_double_get(args[0]);
 		else
 			cscm_error_report("cscm_builtin_proc_subtract", \
@@ -746,9 +744,9 @@ CSCM_OBJECT *cscm_builtin_proc_subtract(size_t n, CSCM_OBJECT **args)
 
 
 		for (i = 1; i < n; i++) {
-			if (args[i]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+			if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_LONG)
 				d -= cscm_num_long_get(args[i]);
-			else if (args[i]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+			else if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 				d -= cscm_num_double_get(args[i]);
 			else
 				cscm_error_report("cscm_builtin_proc_subtract", \
@@ -791,7 +789,7 @@ CSCM_OBJECT *cscm_builtin_proc_multiply(size_t n, CSCM_OBJECT **args)
 
 	flag_long_ret = 1;
 	for (i = 0; i < n; i++) {
-		if (args[i]->type != CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(args[i]) != CSCM_OBJECT_TYPE_NUM_LONG) {
 			flag_long_ret = 0;
 			break;
 		}
@@ -803,13 +801,12 @@ CSCM_OBJECT *cscm_builtin_proc_multiply(size_t n, CSCM_OBJECT **args)
 		for (i = 0; i < n; i++)
 			l *= cscm_num_long_get(args[i]);
 
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, l);
+		ret = cscm_num_long_create(l);
 	} else {
 		for (i = 0; i < n; i++) {
-			if (args[i]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+			if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_LONG)
 				d *= cscm_num_long_get(args[i]);
-			else if (args[i]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+			else if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 				d *= cscm_num_double_get(args[i]);
 			else
 				cscm_error_report("cscm_builtin_proc_multiply", \
@@ -848,9 +845,9 @@ CSCM_OBJECT *cscm_builtin_proc_divide(size_t n, CSCM_OBJECT **args)
 
 
 	if (n == 1) {
-		if (args[0]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+		if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_LONG)
 			d = cscm_num_long_get(args[0]);
-		else if (args[0]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+		else if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 			d = cscm_num_double_get(args[0]);
 		else
 			cscm_error_report("cscm_builtin_proc_divide", \
@@ -866,7 +863,7 @@ CSCM_OBJECT *cscm_builtin_proc_divide(size_t n, CSCM_OBJECT **args)
 
 	flag_long_ret = 1;
 	for (i = 0; i < n; i++) {
-		if (args[i]->type != CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(args[i]) != CSCM_OBJECT_TYPE_NUM_LONG) {
 			flag_long_ret = 0;
 			break;
 		}
@@ -890,12 +887,11 @@ CSCM_OBJECT *cscm_builtin_proc_divide(size_t n, CSCM_OBJECT **args)
 
 
 	if (flag_long_ret) {
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, l);
+		ret = cscm_num_long_create(l);
 	} else {
-		if (args[0]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+		if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_LONG)
 			d = cscm_num_long_get(args[0]);
-		else if (args[0]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+		else if (CSCM_OBJECT_GET_TYPE(args[0]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 			d = cscm_num_double_get(args[0]);
 		else
 			cscm_error_report("cscm_builtin_proc_divide", \
@@ -903,9 +899,9 @@ CSCM_OBJECT *cscm_builtin_proc_divide(size_t n, CSCM_OBJECT **args)
 
 
 		for (i = 1; i < n; i++) {
-			if (args[i]->type == CSCM_OBJECT_TYPE_NUM_LONG)
+			if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_LONG)
 				d /= cscm_num_long_get(args[i]);
-			else if (args[i]->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+			else if (CSCM_OBJECT_GET_TYPE(args[i]) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 				d /= cscm_num_double_get(args[i]);
 			else
 				cscm_error_report("cscm_builtin_proc_divide", \
@@ -940,15 +936,14 @@ CSCM_OBJECT *cscm_builtin_proc_remainder(size_t n, CSCM_OBJECT **args)
 	y = args[1];
 
 
-	if (x->type != CSCM_OBJECT_TYPE_NUM_LONG \
-		|| y->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	if (CSCM_OBJECT_GET_TYPE(x) != CSCM_OBJECT_TYPE_NUM_LONG \
+		|| CSCM_OBJECT_GET_TYPE(y) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_builtin_proc_remainder", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	ret = cscm_num_long_create();
-	cscm_num_long_set(ret, \
-			cscm_num_long_get(x) % cscm_num_long_get(y));
+	ret = cscm_num_long_create(cscm_num_long_get(x)	\
+				% cscm_num_long_get(y));
 
 
 	return ret;
@@ -983,8 +978,8 @@ CSCM_OBJECT *_cscm_builtin_numcmp(char *func, int op, size_t n, CSCM_OBJECT **ar
 	y = args[1];
 
 
-	if (x->type == CSCM_OBJECT_TYPE_NUM_LONG
-		&& y->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		lval_x = cscm_num_long_get(x);
 		lval_y = cscm_num_long_get(y);
 
@@ -1021,16 +1016,16 @@ CSCM_OBJECT *_cscm_builtin_numcmp(char *func, int op, size_t n, CSCM_OBJECT **ar
 	
 	
 	// cast both x and y to double if at least one of them is double
-	if (x->type == CSCM_OBJECT_TYPE_NUM_LONG		\
-		&& y->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG		\
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		dval_x = cscm_num_long_get(x);
 		dval_y = cscm_num_double_get(y);
-	} else if (x->type == CSCM_OBJECT_TYPE_NUM_DOUBLE	\
-		&& y->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	} else if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_DOUBLE	\
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		dval_x = cscm_num_double_get(x);
 		dval_y = cscm_num_long_get(y);
-	} else if (x->type == CSCM_OBJECT_TYPE_NUM_DOUBLE	\
-		&& y->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+	} else if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_DOUBLE	\
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		dval_x = cscm_num_double_get(x);
 		dval_y = cscm_num_double_get(y);
 	} else {
@@ -1094,10 +1089,10 @@ CSCM_OBJECT *cscm_builtin_proc_equal_ssb(size_t n, CSCM_OBJECT **args)
 	y = args[1];
 
 
-	if ((x->type == CSCM_OBJECT_TYPE_BOOL_TRUE		\
-		|| x->type == CSCM_OBJECT_TYPE_BOOL_FALSE)	\
-		&& (y->type == CSCM_OBJECT_TYPE_BOOL_TRUE	\
-		|| y->type == CSCM_OBJECT_TYPE_BOOL_FALSE)) {
+	if ((CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_BOOL_TRUE		\
+		|| CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_BOOL_FALSE)	\
+		&& (CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_BOOL_TRUE	\
+		|| CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_BOOL_FALSE)) {
 		if (x != CSCM_TRUE && x != CSCM_FALSE)
 			cscm_error_report("cscm_builtin_proc_equal_ssb", \
 					CSCM_ERROR_BOOL_EXTRA_COPY);
@@ -1109,17 +1104,8 @@ CSCM_OBJECT *cscm_builtin_proc_equal_ssb(size_t n, CSCM_OBJECT **args)
 			return CSCM_TRUE;
 		else
 			return CSCM_FALSE;
-	} else if (x->type == CSCM_OBJECT_TYPE_SYMBOL \
-		&& y->type == CSCM_OBJECT_TYPE_SYMBOL) {
-		text_x = cscm_symbol_get(x);
-		text_y = cscm_symbol_get(y);
-
-		if (!strcmp(text_x, text_y))
-			return CSCM_TRUE;
-		else
-			return CSCM_FALSE;
-	} else if (x->type == CSCM_OBJECT_TYPE_STRING \
-		&& y->type == CSCM_OBJECT_TYPE_STRING) {
+	} else if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_STRING \
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_STRING) {
 		text_x = cscm_string_get(x);
 		text_y = cscm_string_get(y);
 
@@ -1127,7 +1113,7 @@ CSCM_OBJECT *cscm_builtin_proc_equal_ssb(size_t n, CSCM_OBJECT **args)
 			return CSCM_TRUE;
 		else
 			return CSCM_FALSE;
-	} else { // in all other situations, compare addresses
+	} else { // symbols are interned, compare addresses like others
 		if (x == y)
 			return CSCM_TRUE;
 		else
@@ -1153,11 +1139,11 @@ CSCM_OBJECT *cscm_builtin_proc_equal(size_t n, CSCM_OBJECT **args)
 	y = args[1];
 
 
-	if ((x->type == CSCM_OBJECT_TYPE_NUM_LONG			\
-		|| x->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)		\
+	if ((CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG			\
+		|| CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_DOUBLE)		\
 		&&							\
-		(y->type == CSCM_OBJECT_TYPE_NUM_LONG			\
-	 	|| y->type == CSCM_OBJECT_TYPE_NUM_DOUBLE))
+		(CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_LONG			\
+	 	|| CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_DOUBLE))
 		return cscm_builtin_proc_equal_num(n, args);		
 	else
 		return cscm_builtin_proc_equal_ssb(n, args);		
@@ -1218,7 +1204,7 @@ CSCM_OBJECT *cscm_builtin_proc_is_string(size_t n, CSCM_OBJECT **args)
 	x = args[0];
 
 
-	if (x->type == CSCM_OBJECT_TYPE_STRING)
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_STRING)
 		return CSCM_TRUE;
 	else
 		return CSCM_FALSE;
@@ -1239,7 +1225,7 @@ CSCM_OBJECT *cscm_builtin_proc_is_symbol(size_t n, CSCM_OBJECT **args)
 	x = args[0];
 
 
-	if (x->type == CSCM_OBJECT_TYPE_SYMBOL)
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_SYMBOL)
 		return CSCM_TRUE;
 	else
 		return CSCM_FALSE;
@@ -1260,8 +1246,8 @@ CSCM_OBJECT *cscm_builtin_proc_is_number(size_t n, CSCM_OBJECT **args)
 	x = args[0];
 
 
-	if (x->type == CSCM_OBJECT_TYPE_NUM_LONG \
-		|| x->type == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG \
+		|| CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
 		return CSCM_TRUE;
 	else
 		return CSCM_FALSE;
@@ -1282,7 +1268,7 @@ CSCM_OBJECT *cscm_builtin_proc_is_pair(size_t n, CSCM_OBJECT **args)
 	x = args[0];
 
 
-	if (x->type == CSCM_OBJECT_TYPE_PAIR)
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_PAIR)
 		return CSCM_TRUE;
 	else
 		return CSCM_FALSE;
@@ -1336,7 +1322,7 @@ CSCM_OBJECT *cscm_builtin_proc_include(size_t n, CSCM_OBJECT **args)
 	mod_name = args[0];
 
 
-	if (mod_name->type != CSCM_OBJECT_TYPE_STRING)
+	if (CSCM_OBJECT_GET_TYPE(mod_name) != CSCM_OBJECT_TYPE_STRING)
 		cscm_error_report("cscm_builtin_proc_include", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -1380,10 +1366,10 @@ CSCM_OBJECT *cscm_builtin_proc_max(size_t n, CSCM_OBJECT **args)
 
 	number = args[0];
 
-	if (number->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		flag_long = 1;
 		max_long_number = cscm_num_long_get(number);
-	} else if (number->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+	} else if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		flag_long = 0;
 		max_double_number = cscm_num_double_get(number);
 	} else {
@@ -1395,7 +1381,7 @@ CSCM_OBJECT *cscm_builtin_proc_max(size_t n, CSCM_OBJECT **args)
 	for (i = 1; i < n; i++) {
 		number = args[i];
 
-		if (number->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_LONG) {
 			if (flag_long) {
 				long_number = cscm_num_long_get(number);
 
@@ -1407,7 +1393,7 @@ CSCM_OBJECT *cscm_builtin_proc_max(size_t n, CSCM_OBJECT **args)
 				if (max_double_number < double_number)
 					max_double_number = double_number;
 			}
-		} else if (number->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+		} else if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 			double_number = cscm_num_double_get(number);
 
 			if (flag_long) {
@@ -1425,8 +1411,7 @@ CSCM_OBJECT *cscm_builtin_proc_max(size_t n, CSCM_OBJECT **args)
 
 
 	if (flag_long) {
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, max_long_number);
+		ret = cscm_num_long_create(max_long_number);
 	} else {
 		ret = cscm_num_double_create();
 		cscm_num_double_set(ret, max_double_number);
@@ -1463,10 +1448,10 @@ CSCM_OBJECT *cscm_builtin_proc_min(size_t n, CSCM_OBJECT **args)
 
 	number = args[0];
 
-	if (number->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		flag_long = 1;
 		min_long_number = cscm_num_long_get(number);
-	} else if (number->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+	} else if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		flag_long = 0;
 		min_double_number = cscm_num_double_get(number);
 	} else {
@@ -1478,7 +1463,7 @@ CSCM_OBJECT *cscm_builtin_proc_min(size_t n, CSCM_OBJECT **args)
 	for (i = 1; i < n; i++) {
 		number = args[i];
 
-		if (number->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+		if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_LONG) {
 			if (flag_long) {
 				long_number = cscm_num_long_get(number);
 
@@ -1490,7 +1475,7 @@ CSCM_OBJECT *cscm_builtin_proc_min(size_t n, CSCM_OBJECT **args)
 				if (min_double_number > double_number)
 					min_double_number = double_number;
 			}
-		} else if (number->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+		} else if (CSCM_OBJECT_GET_TYPE(number) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 			double_number = cscm_num_double_get(number);
 
 			if (flag_long) {
@@ -1508,8 +1493,7 @@ CSCM_OBJECT *cscm_builtin_proc_min(size_t n, CSCM_OBJECT **args)
 
 
 	if (flag_long) {
-		ret = cscm_num_long_create();
-		cscm_num_long_set(ret, min_long_number);
+		ret = cscm_num_long_create(min_long_number);
 	} else {
 		ret = cscm_num_double_create();
 		cscm_num_double_set(ret, min_double_number);
@@ -1524,7 +1508,8 @@ CSCM_OBJECT *cscm_builtin_proc_min(size_t n, CSCM_OBJECT **args)
 
 CSCM_OBJECT *cscm_builtin_proc_apply(size_t n, CSCM_OBJECT **args)
 {
-	CSCM_OBJECT *proc, *arg_list;
+	int i;
+	CSCM_OBJECT *proc, *arg_list, *pair;
 
 	size_t len;
 	CSCM_OBJECT **arg_obj_ptrs;
@@ -1542,11 +1527,11 @@ CSCM_OBJECT *cscm_builtin_proc_apply(size_t n, CSCM_OBJECT **args)
 	arg_list = args[1];
 
 
-	if (proc->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& proc->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_apply", \
 				CSCM_ERROR_OBJECT_TYPE);
-	else if (arg_list->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(arg_list) != CSCM_OBJECT_TYPE_PAIR \
 		&& arg_list != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_apply", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -1563,12 +1548,17 @@ CSCM_OBJECT *cscm_builtin_proc_apply(size_t n, CSCM_OBJECT **args)
 		cscm_gc_dec(proc);
 	} else {
 		len = cscm_list_get_len(arg_list);
-		arg_obj_ptrs = cscm_list_to_object_ptrs(arg_list);
+		arg_obj_ptrs = cscm_object_ptrs_push(len);
+
+		for (i = 0, pair = arg_list; i < len; i++) {
+			arg_obj_ptrs[i] = cscm_pair_get_car(pair);
+			pair = cscm_pair_get_cdr(pair);
+		}
 
 		ret = cscm_apply(proc, len, arg_obj_ptrs);
 		cscm_gc_dec(proc);
 
-		free(arg_obj_ptrs);
+		cscm_object_ptrs_pop(arg_obj_ptrs);
 	}
 
 
@@ -1592,12 +1582,12 @@ CSCM_OBJECT *cscm_builtin_proc_not(size_t n, CSCM_OBJECT **args)
 
 	if (obj == CSCM_FALSE)
 		return CSCM_TRUE;
-	else if (obj->type == CSCM_OBJECT_TYPE_BOOL_FALSE)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_FALSE)
 		cscm_error_report("cscm_builtin_proc_not", \
 				CSCM_ERROR_BOOL_EXTRA_COPY);
 	else if (obj == CSCM_TRUE)
 		return CSCM_FALSE;
-	else if (obj->type == CSCM_OBJECT_TYPE_BOOL_TRUE)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_BOOL_TRUE)
 		cscm_error_report("cscm_builtin_proc_not", \
 				CSCM_ERROR_BOOL_EXTRA_COPY);
 	else
@@ -1632,3 +1622,208 @@ CSCM_OBJECT *cscm_builtin_proc_error(size_t n, CSCM_OBJECT **args)
 
 	exit(1);
 }
+
+
+
+
+char *_cscm_builtin_inline_names[] = {
+	"+", "-", "*",
+	"=", ">", ">=", "<", "<=",
+
+	NULL
+};
+
+
+CSCM_PROC_PRIM_FUNC _cscm_builtin_inline_funcs[] = {
+	cscm_builtin_proc_add,
+	cscm_builtin_proc_subtract,
+	cscm_builtin_proc_multiply,
+
+	cscm_builtin_proc_equal_num,
+	cscm_builtin_proc_greater_than,
+	cscm_builtin_proc_greater_equal,
+	cscm_builtin_proc_less_than,
+	cscm_builtin_proc_less_equal,
+
+	NULL
+};
+
+
+/* return CSCM_BUILTIN_INLINE_NONE when name is not inlined */
+int cscm_builtin_inline_find(char *name)
+{
+	int op;
+
+
+	if (name == NULL)
+		cscm_error_report("cscm_builtin_inline_find", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	for (op = 0; _cscm_builtin_inline_names[op]; op++)
+		if (!strcmp(name, _cscm_builtin_inline_names[op]))
+			return op;
+
+
+	return CSCM_BUILTIN_INLINE_NONE;
+}
+
+
+CSCM_PROC_PRIM_FUNC cscm_builtin_inline_get_f(int op)
+{
+	if (op < 0 || op >= CSCM_BUILTIN_INLINE_NONE)
+		cscm_error_report("cscm_builtin_inline_get_f", \
+				CSCM_ERROR_BUILTIN_BAD_OP);
+
+
+	return _cscm_builtin_inline_funcs[op];
+}
+
+
+/*	Return what the primitive of op returns for x and y, or NULL
+ * when they are not both numbers, or when a long result overflows, in
+ * which case the primitive itself has to be applied to report errors
+ * or to compute the same result. Both fixnums are handled first. */
+CSCM_OBJECT *cscm_builtin_inline_apply(int op, \
+			CSCM_OBJECT *x, CSCM_OBJECT *y)
+{
+	int result;
+
+	long lx, ly, l;
+	double dx, dy, d;
+
+	CSCM_OBJECT *ret;
+
+
+	if (CSCM_OBJECT_IS_FIXNUM(x) && CSCM_OBJECT_IS_FIXNUM(y)) {
+		lx = CSCM_FIXNUM_GET(x);
+		ly = CSCM_FIXNUM_GET(y);
+
+		switch (op)
+		{
+			case CSCM_BUILTIN_INLINE_ADD: // never overflows
+				return cscm_num_long_create(lx + ly);
+			case CSCM_BUILTIN_INLINE_SUBTRACT:
+				return cscm_num_long_create(lx - ly);
+			case CSCM_BUILTIN_INLINE_MULTIPLY:
+				if (__builtin_mul_overflow(lx, ly, &l))
+					return NULL;
+
+				return cscm_num_long_create(l);
+			case CSCM_BUILTIN_INLINE_EQUAL_NUM:
+				return lx == ly ? CSCM_TRUE : CSCM_FALSE;
+			case CSCM_BUILTIN_INLINE_GREATER:
+				return lx > ly ? CSCM_TRUE : CSCM_FALSE;
+			case CSCM_BUILTIN_INLINE_GREATER_EQ:
+				return lx >= ly ? CSCM_TRUE : CSCM_FALSE;
+			case CSCM_BUILTIN_INLINE_LESS:
+				return lx < ly ? CSCM_TRUE : CSCM_FALSE;
+			case CSCM_BUILTIN_INLINE_LESS_EQ:
+				return lx <= ly ? CSCM_TRUE : CSCM_FALSE;
+			default:
+				cscm_error_report("cscm_builtin_inline_apply", \
+						CSCM_ERROR_BUILTIN_BAD_OP);
+		}
+	}
+
+
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG	\
+		&& CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_LONG) {
+		lx = cscm_num_long_get(x);
+		ly = cscm_num_long_get(y);
+
+		switch (op)
+		{
+			case CSCM_BUILTIN_INLINE_ADD:
+				if (__builtin_add_overflow(lx, ly, &l))
+					return NULL;
+
+				return cscm_num_long_create(l);
+			case CSCM_BUILTIN_INLINE_SUBTRACT:
+				if (__builtin_sub_overflow(lx, ly, &l))
+					return NULL;
+
+				return cscm_num_long_create(l);
+			case CSCM_BUILTIN_INLINE_MULTIPLY:
+				if (__builtin_mul_overflow(lx, ly, &l))
+					return NULL;
+
+				return cscm_num_long_create(l);
+			case CSCM_BUILTIN_INLINE_EQUAL_NUM:
+				result = lx == ly;
+				break;
+			case CSCM_BUILTIN_INLINE_GREATER:
+				result = lx > ly;
+				break;
+			case CSCM_BUILTIN_INLINE_GREATER_EQ:
+				result = lx >= ly;
+				break;
+			case CSCM_BUILTIN_INLINE_LESS:
+				result = lx < ly;
+				break;
+			case CSCM_BUILTIN_INLINE_LESS_EQ:
+				result = lx <= ly;
+				break;
+			default:
+				cscm_error_report("cscm_builtin_inline_apply", \
+						CSCM_ERROR_BUILTIN_BAD_OP);
+		}
+
+
+		return result ? CSCM_TRUE : CSCM_FALSE;
+	}
+
+
+	if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_LONG)
+		dx = cscm_num_long_get(x);
+	else if (CSCM_OBJECT_GET_TYPE(x) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+		dx = cscm_num_double_get(x);
+	else
+		return NULL;
+
+	if (CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_LONG)
+		dy = cscm_num_long_get(y);
+	else if (CSCM_OBJECT_GET_TYPE(y) == CSCM_OBJECT_TYPE_NUM_DOUBLE)
+		dy = cscm_num_double_get(y);
+	else
+		return NULL;
+
+
+	/* the same steps as the primitives, e.g. (+ -0.0 -0.0) is 0.0 */
+	switch (op)
+	{
+		case CSCM_BUILTIN_INLINE_ADD:
+			d = 0;
+			d += dx;
+			d += dy;
+			break;
+		case CSCM_BUILTIN_INLINE_SUBTRACT:
+			d = dx - dy;
+			break;
+		case CSCM_BUILTIN_INLINE_MULTIPLY:
+			d = 1;
+			d *= dx;
+			d *= dy;
+			break;
+		case CSCM_BUILTIN_INLINE_EQUAL_NUM:
+			return dx == dy ? CSCM_TRUE : CSCM_FALSE;
+		case CSCM_BUILTIN_INLINE_GREATER:
+			return dx > dy ? CSCM_TRUE : CSCM_FALSE;
+		case CSCM_BUILTIN_INLINE_GREATER_EQ:
+			return dx >= dy ? CSCM_TRUE : CSCM_FALSE;
+		case CSCM_BUILTIN_INLINE_LESS:
+			return dx < dy ? CSCM_TRUE : CSCM_FALSE;
+		case CSCM_BUILTIN_INLINE_LESS_EQ:
+			return dx <= dy ? CSCM_TRUE : CSCM_FALSE;
+		default:
+			cscm_error_report("cscm_builtin_inline_apply", \
+					CSCM_ERROR_BUILTIN_BAD_OP);
+	}
+
+
+	ret = cscm_num_double_create();
+	cscm_num_double_set(ret, d);
+
+
+	return ret;
+}
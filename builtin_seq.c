@@ -23,6 +23,7 @@
 #include "core.h"
 #include "num.h"
 #include "bool.h"
+#include "symbol.h"
 #include "env.h"
 #include "proc.h"
 #include "gc.h"
@@ -38,11 +39,14 @@ CSCM_OBJECT *_cscm_builtin_proc_sort_cmp_proc;
 int _cscm_builtin_proc_sort_cmp(const void *a, const void *b)
 {
 	CSCM_OBJECT *proc;
-	CSCM_OBJECT *args[2];
+	CSCM_OBJECT **args;
 
 	CSCM_OBJECT *result;
+	int ret;
 
 
+	args = cscm_object_ptrs_push(2);
+
 	args[0] = *(CSCM_OBJECT **)a;
 	args[1] = *(CSCM_OBJECT **)b;
 
@@ -56,12 +60,16 @@ int _cscm_builtin_proc_sort_cmp(const void *a, const void *b)
 	result = cscm_apply(proc, 2, args);
 	cscm_gc_dec(proc);
 
-	if (result->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	if (CSCM_OBJECT_GET_TYPE(result) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_builtin_proc_sort_cmp", \
 				CSCM_ERROR_BUILTIN_RETURN_TYPE);
 
+	ret = (int)cscm_num_long_get(result);
+
 
-	return (int)cscm_num_long_get(result);
+	cscm_object_ptrs_pop(args);
+
+	return ret;
 }
 
 
@@ -87,11 +95,11 @@ CSCM_OBJECT *cscm_builtin_proc_sort(size_t n, CSCM_OBJECT **args)
 	seq = args[1];
 
 
-	if ((cmp_proc->type != CSCM_OBJECT_TYPE_PROC_PRIM)
-		&& (cmp_proc->type != CSCM_OBJECT_TYPE_PROC_COMP))
+	if ((CSCM_OBJECT_GET_TYPE(cmp_proc) != CSCM_OBJECT_TYPE_PROC_PRIM)
+		&& (CSCM_OBJECT_GET_TYPE(cmp_proc) != CSCM_OBJECT_TYPE_PROC_COMP))
 		cscm_error_report("cscm_builtin_proc_sort", \
 				CSCM_ERROR_BUILTIN_BAD_PROC);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_sort", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -137,14 +145,13 @@ CSCM_OBJECT *cscm_builtin_proc_length(size_t n, CSCM_OBJECT **args)
 
 	seq = args[0];
 
-	if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_length", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
 
 
-	ret = cscm_num_long_create();
-	cscm_num_long_set(ret, (long)cscm_list_get_len(seq));
+	ret = cscm_num_long_create((long)cscm_list_get_len(seq));
 
 
 	return ret;
@@ -171,10 +178,10 @@ CSCM_OBJECT *cscm_builtin_proc_list_ref(size_t n, CSCM_OBJECT **args)
 	index = args[1];
 
 
-	if (index->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	if (CSCM_OBJECT_GET_TYPE(index) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_builtin_proc_list_ref", \
 				CSCM_ERROR_LIST_INDEX);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR) // do not support nil
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR) // do not support nil
 		cscm_error_report("cscm_builtin_proc_list_ref", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
 
@@ -208,10 +215,10 @@ CSCM_OBJECT *cscm_builtin_proc_range(size_t n, CSCM_OBJECT **args)
 	first = args[0];
 	last = args[1];
 
-	if (first->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	if (CSCM_OBJECT_GET_TYPE(first) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_builtin_proc_range", \
 				CSCM_ERROR_OBJECT_TYPE);
-	else if (last->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	else if (CSCM_OBJECT_GET_TYPE(last) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_builtin_proc_range", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -222,7 +229,7 @@ CSCM_OBJECT *cscm_builtin_proc_range(size_t n, CSCM_OBJECT **args)
 	if (n == 3) {
 		step = args[2];
 
-		if (step->type != CSCM_OBJECT_TYPE_NUM_LONG)
+		if (CSCM_OBJECT_GET_TYPE(step) != CSCM_OBJECT_TYPE_NUM_LONG)
 			cscm_error_report("cscm_builtin_proc_range", \
 					CSCM_ERROR_OBJECT_TYPE);
 
@@ -254,10 +261,10 @@ CSCM_OBJECT *cscm_builtin_proc_append(size_t n, CSCM_OBJECT **args)
 	y = args[1];
 
 
-	if ((x->type != CSCM_OBJECT_TYPE_PAIR		\
+	if ((CSCM_OBJECT_GET_TYPE(x) != CSCM_OBJECT_TYPE_PAIR		\
 		&& x != CSCM_NIL)			\
 		||					\
-		(y->type != CSCM_OBJECT_TYPE_PAIR	\
+		(CSCM_OBJECT_GET_TYPE(y) != CSCM_OBJECT_TYPE_PAIR	\
 		&& y != CSCM_NIL))
 		cscm_error_report("cscm_builtin_proc_append", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -284,7 +291,7 @@ CSCM_OBJECT *cscm_builtin_proc_reverse(size_t n, CSCM_OBJECT **args)
 	seq = args[0];
 
 
-	if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_reverse", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -311,7 +318,7 @@ CSCM_OBJECT *cscm_builtin_proc_list_copy(size_t n, CSCM_OBJECT **args)
 	seq = args[0];
 
 
-	if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_list_copy", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -332,7 +339,7 @@ CSCM_OBJECT *cscm_builtin_proc_map(size_t n, CSCM_OBJECT **args)
 	CSCM_OBJECT *new_pair;
 	CSCM_OBJECT *ret;
 
-	CSCM_OBJECT *proc_args[1];
+	CSCM_OBJECT **proc_args;
 	CSCM_OBJECT *item_result;
 
 
@@ -346,11 +353,11 @@ CSCM_OBJECT *cscm_builtin_proc_map(size_t n, CSCM_OBJECT **args)
 	seq = args[1];
 
 
-	if (proc->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& proc->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_map", \
 				CSCM_ERROR_BUILTIN_BAD_PROC);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_map", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -365,6 +372,8 @@ CSCM_OBJECT *cscm_builtin_proc_map(size_t n, CSCM_OBJECT **args)
 	cscm_gc_inc(proc);
 
 
+	proc_args = cscm_object_ptrs_push(1);
+
 	new_pair = cscm_pair_create();
 	ret = new_pair;
 
@@ -386,7 +395,7 @@ CSCM_OBJECT *cscm_builtin_proc_map(size_t n, CSCM_OBJECT **args)
 		if (src == NULL)
 			cscm_error_report("cscm_builtin_proc_map", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_builtin_proc_map", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -397,6 +406,8 @@ CSCM_OBJECT *cscm_builtin_proc_map(size_t n, CSCM_OBJECT **args)
 	cscm_pair_set_cdr(dest, CSCM_NIL);
 
 
+	cscm_object_ptrs_pop(proc_args);
+
 	cscm_gc_dec(proc);
 	return ret;
 }
@@ -411,7 +422,7 @@ CSCM_OBJECT *cscm_builtin_proc_for_each(size_t n, CSCM_OBJECT **args)
 
 	CSCM_OBJECT *pair;
 
-	CSCM_OBJECT *action_args[1];
+	CSCM_OBJECT **action_args;
 
 
 	cscm_builtin_check_args("cscm_builtin_proc_for_each",	\
@@ -424,11 +435,11 @@ CSCM_OBJECT *cscm_builtin_proc_for_each(size_t n, CSCM_OBJECT **args)
 	seq = args[1];
 
 
-	if (action->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& action->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(action) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(action) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_for_each", \
 				CSCM_ERROR_BUILTIN_BAD_ACTION);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_for_each", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -443,6 +454,8 @@ CSCM_OBJECT *cscm_builtin_proc_for_each(size_t n, CSCM_OBJECT **args)
 	cscm_gc_inc(action);
 
 
+	action_args = cscm_object_ptrs_push(1);
+
 	pair = seq;
 
 	do {
@@ -455,13 +468,15 @@ CSCM_OBJECT *cscm_builtin_proc_for_each(size_t n, CSCM_OBJECT **args)
 		if (pair == NULL)
 			cscm_error_report("cscm_builtin_proc_for_each", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (pair->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR \
 			&& pair != CSCM_NIL)
 			cscm_error_report("cscm_builtin_proc_for_each", \
 					CSCM_ERROR_LIST_NOT_SEQ);
 	} while (pair != CSCM_NIL);
 
 
+	cscm_object_ptrs_pop(action_args);
+
 	cscm_gc_dec(action);
 	return CSCM_TRUE;
 }
@@ -478,7 +493,7 @@ CSCM_OBJECT *cscm_builtin_proc_filter(size_t n, CSCM_OBJECT **args)
 	CSCM_OBJECT *new_pair;
 	CSCM_OBJECT *ret;
 
-	CSCM_OBJECT *pred_args[1];
+	CSCM_OBJECT **pred_args;
 	CSCM_OBJECT *pred_result;
 
 
@@ -492,11 +507,11 @@ CSCM_OBJECT *cscm_builtin_proc_filter(size_t n, CSCM_OBJECT **args)
 	seq = args[1];
 
 
-	if (pred->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& pred->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(pred) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(pred) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_filter", \
 				CSCM_ERROR_BUILTIN_BAD_PRED);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_filter", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -511,6 +526,8 @@ CSCM_OBJECT *cscm_builtin_proc_filter(size_t n, CSCM_OBJECT **args)
 	cscm_gc_inc(pred);
 
 
+	pred_args = cscm_object_ptrs_push(1);
+
 	new_pair = cscm_pair_create();
 	ret = new_pair;
 
@@ -532,7 +549,7 @@ CSCM_OBJECT *cscm_builtin_proc_filter(size_t n, CSCM_OBJECT **args)
 		if (src == NULL)
 			cscm_error_report("cscm_builtin_proc_filter", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_builtin_proc_filter", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -543,6 +560,8 @@ CSCM_OBJECT *cscm_builtin_proc_filter(size_t n, CSCM_OBJECT **args)
 	cscm_pair_set_cdr(dest, CSCM_NIL);
 
 
+	cscm_object_ptrs_pop(pred_args);
+
 	cscm_gc_dec(pred);
 	return ret;
 }
@@ -554,7 +573,7 @@ CSCM_OBJECT *_do_cscm_builtin_proc_accumulate(CSCM_OBJECT *proc,	\
 					CSCM_OBJECT *initial,		\
 					CSCM_OBJECT *rest_seq)
 {
-	CSCM_OBJECT *proc_args[2];
+	CSCM_OBJECT **proc_args;
 
 	CSCM_OBJECT *ret;
 
@@ -562,7 +581,7 @@ CSCM_OBJECT *_do_cscm_builtin_proc_accumulate(CSCM_OBJECT *proc,	\
 	if (rest_seq == NULL)
 		cscm_error_report("_do_cscm_builtin_proc_accumulate", \
 				CSCM_ERROR_LIST_NOT_SEQ);
-	else if (rest_seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(rest_seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& rest_seq != CSCM_NIL)
 		cscm_error_report("_do_cscm_builtin_proc_accumulate", \
 				CSCM_ERROR_LIST_NOT_SEQ);
@@ -571,6 +590,8 @@ CSCM_OBJECT *_do_cscm_builtin_proc_accumulate(CSCM_OBJECT *proc,	\
 	if (rest_seq == CSCM_NIL) {
 		ret = initial;
 	} else {
+		proc_args = cscm_object_ptrs_push(2);
+
 		proc_args[0] = cscm_pair_get_car(rest_seq);
 		proc_args[1] = _do_cscm_builtin_proc_accumulate(	\
 						proc,			\
@@ -584,6 +605,8 @@ CSCM_OBJECT *_do_cscm_builtin_proc_accumulate(CSCM_OBJECT *proc,	\
 		cscm_gc_inc(proc);
 		ret = cscm_apply(proc, 2, proc_args);
 		cscm_gc_dec(proc);
+
+		cscm_object_ptrs_pop(proc_args);
 	}
 
 
@@ -611,11 +634,11 @@ CSCM_OBJECT *cscm_builtin_proc_accumulate(size_t n, CSCM_OBJECT **args)
 	seq = args[2];
 
 
-	if (proc->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& proc->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_accumulate", \
 				CSCM_ERROR_BUILTIN_BAD_PROC);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_accumulate", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -638,7 +661,7 @@ CSCM_OBJECT *cscm_builtin_proc_fold_left(size_t n, CSCM_OBJECT **args)
 
 	CSCM_OBJECT *pair;
 
-	CSCM_OBJECT *proc_args[1];
+	CSCM_OBJECT **proc_args;
 	CSCM_OBJECT *last_result;
 
 
@@ -653,11 +676,11 @@ CSCM_OBJECT *cscm_builtin_proc_fold_left(size_t n, CSCM_OBJECT **args)
 	seq = args[2];
 
 
-	if (proc->type != CSCM_OBJECT_TYPE_PROC_PRIM \
-		&& proc->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	if (CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_PRIM \
+		&& CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_builtin_proc_fold_left", \
 				CSCM_ERROR_BUILTIN_BAD_PROC);
-	else if (seq->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(seq) != CSCM_OBJECT_TYPE_PAIR \
 		&& seq != CSCM_NIL)
 		cscm_error_report("cscm_builtin_proc_fold_left", \
 				CSCM_ERROR_BUILTIN_BAD_SEQ);
@@ -672,6 +695,8 @@ CSCM_OBJECT *cscm_builtin_proc_fold_left(size_t n, CSCM_OBJECT **args)
 	cscm_gc_inc(proc);
 
 
+	proc_args = cscm_object_ptrs_push(2);
+
 	pair = seq;
 	last_result = initial;
 
@@ -687,13 +712,15 @@ CSCM_OBJECT *cscm_builtin_proc_fold_left(size_t n, CSCM_OBJECT **args)
 		if (pair == NULL)
 			cscm_error_report("cscm_builtin_proc_fold_left", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (pair->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR \
 			&& pair != CSCM_NIL)
 			cscm_error_report("cscm_builtin_proc_fold_left", \
 					CSCM_ERROR_LIST_NOT_SEQ);
 	} while (pair != CSCM_NIL);
 
 
+	cscm_object_ptrs_pop(proc_args);
+
 	cscm_gc_dec(proc);
 	return last_result;
 }
@@ -713,49 +740,49 @@ void cscm_builtin_module_func_seq()
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_sort);
-	cscm_env_add_var(global_env, "sort", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("sort"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_length);
-	cscm_env_add_var(global_env, "length", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("length"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_list_ref);
-	cscm_env_add_var(global_env, "list-ref", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("list-ref"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_range);
-	cscm_env_add_var(global_env, "range", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("range"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_append);
-	cscm_env_add_var(global_env, "append", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("append"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_reverse);
-	cscm_env_add_var(global_env, "reverse", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("reverse"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_list_copy);
-	cscm_env_add_var(global_env, "list-copy", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("list-copy"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_map);
-	cscm_env_add_var(global_env, "map", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("map"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_for_each);
-	cscm_env_add_var(global_env, "for-each", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("for-each"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_filter);
-	cscm_env_add_var(global_env, "filter", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("filter"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_accumulate);
-	cscm_env_add_var(global_env, "accumulate", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("accumulate"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_fold_left);
-	cscm_env_add_var(global_env, "fold-left", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("fold-left"), proc);
 }
@@ -52,21 +52,20 @@ CSCM_OBJECT *cscm_builtin_proc_symbol(size_t n, CSCM_OBJECT **args)
 	obj = args[0];
 
 
-	symbol = cscm_symbol_create();
-
-	if (obj->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		snprintf(num_buf, CSCM_NUM_MAX_TEXT_LEN, "%ld", \
 			cscm_num_long_get(obj));
 
-		cscm_symbol_set(symbol, num_buf);
-	} else if (obj->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+		symbol = cscm_symbol_intern(num_buf);
+	} else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		snprintf(num_buf, CSCM_NUM_MAX_TEXT_LEN, "%f", \
 			cscm_num_double_get(obj));
 
-		cscm_symbol_set(symbol, num_buf);
-	} else if (obj->type == CSCM_OBJECT_TYPE_SYMBOL \
-		|| obj->type == CSCM_OBJECT_TYPE_STRING) {
-		cscm_symbol_set(symbol, (char *)obj->value);
+		symbol = cscm_symbol_intern(num_buf);
+	} else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_SYMBOL) {
+		symbol = obj;
+	} else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_STRING) {
+		symbol = cscm_symbol_intern((char *)obj->value);
 	} else {
 		cscm_error_report("cscm_builtin_proc_symbol", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -100,7 +99,7 @@ CSCM_OBJECT *cscm_builtin_proc_symbol_append(size_t n, CSCM_OBJECT **args)
 	for (i = 0; i < n; i++) {
 		symbol = args[i];
 		
-		if (symbol->type != CSCM_OBJECT_TYPE_SYMBOL)
+		if (CSCM_OBJECT_GET_TYPE(symbol) != CSCM_OBJECT_TYPE_SYMBOL)
 			cscm_error_report("cscm_builtin_proc_symbol_append", \
 					CSCM_ERROR_OBJECT_TYPE);
 
@@ -127,8 +126,7 @@ CSCM_OBJECT *cscm_builtin_proc_symbol_append(size_t n, CSCM_OBJECT **args)
 	*dest = 0;
 
 
-	symbol = cscm_symbol_create();
-	cscm_symbol_set_simple(symbol, text);
+	symbol = cscm_symbol_intern_simple(text);
 
 
 	return symbol;
@@ -149,9 +147,9 @@ void cscm_builtin_module_func_symbol()
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_symbol);
-	cscm_env_add_var(global_env, "symbol", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("symbol"), proc);
 
 	proc = cscm_proc_prim_create();
 	cscm_proc_prim_set(proc, cscm_builtin_proc_symbol_append);
-	cscm_env_add_var(global_env, "symbol-append", proc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("symbol-append"), proc);
 }
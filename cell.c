@@ -0,0 +1,116 @@
+/* cell.c -- shared cells of captured variables
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <stdio.h>
+
+#include "error.h"
+#include "object.h"
+#include "gc.h"
+#include "cell.h"
+
+
+
+
+CSCM_OBJECT *cscm_cell_create(CSCM_OBJECT *val)
+{
+	CSCM_OBJECT *obj;
+
+
+	if (val == NULL)
+		cscm_error_report("cscm_cell_create", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	obj = cscm_object_create();
+
+	obj->type = CSCM_OBJECT_TYPE_CELL;
+
+
+	obj->value = val;
+	cscm_gc_inc(val);
+
+
+	return obj;
+}
+
+
+
+
+void cscm_cell_set(CSCM_OBJECT *cell, CSCM_OBJECT *val)
+{
+	CSCM_OBJECT *old;
+
+
+	if (cell == NULL || val == NULL)
+		cscm_error_report("cscm_cell_set", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(cell) != CSCM_OBJECT_TYPE_CELL)
+		cscm_error_report("cscm_cell_set", \
+				CSCM_ERROR_OBJECT_TYPE);
+
+
+	cscm_gc_inc(val); // before the old value is released
+
+	old = CSCM_CELL_GET(cell);
+	cscm_gc_dec(old);
+	cscm_gc_free(old);
+
+
+	cell->value = val;
+}
+
+
+
+
+void cscm_cell_print(CSCM_OBJECT *obj, FILE *stream)
+{
+	if (obj == NULL || stream == NULL)
+		cscm_error_report("cscm_cell_print", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_CELL)
+		cscm_error_report("cscm_cell_print", \
+				CSCM_ERROR_OBJECT_TYPE);
+
+
+	fputs("<cell ", stream);
+	cscm_object_print(CSCM_CELL_GET(obj), stream);
+	fputc('>', stream);
+}
+
+
+
+
+void cscm_cell_free(CSCM_OBJECT *obj)
+{
+	CSCM_OBJECT *val;
+
+
+	if (obj == NULL)
+		cscm_error_report("cscm_cell_free", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_CELL)
+		cscm_error_report("cscm_cell_free", \
+				CSCM_ERROR_OBJECT_TYPE);
+
+
+	val = CSCM_CELL_GET(obj);
+	cscm_gc_dec(val);
+	cscm_gc_free(val);
+
+
+	cscm_object_destroy(obj);
+}
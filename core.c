@@ -29,6 +29,7 @@
 #include "definition.h"
 #include "begin.h"
 #include "let.h"
+#include "do.h"
 #include "lambda.h"
 #include "if.h"
 #include "cond.h"
@@ -38,8 +39,12 @@
 #include "quasiquote.h"
 #include "gc.h"
 #include "env.h"
+#include "mem.h"
 #include "pair.h"
 #include "tco.h"
+#include "scope.h"
+#include "vm.h"
+#include "builtin.h"
 #include "core.h"
 
 
@@ -65,7 +70,11 @@ CSCM_OBJECT *cscm_eval(CSCM_AST_NODE *exp, CSCM_OBJECT *env)
 	#ifdef __CSCM_GC_DEBUG__
 		cscm_gc_show_total_object_count("EXECUTE");
 	#endif
-	ret = cscm_ef_exec(ef, env);
+	if (cscm_vm_mode)
+		ret = cscm_vm_exec(ef, env);
+	else
+		ret = cscm_ef_exec(ef, env);
+
 	if (ret)
 		cscm_gc_inc(ret); // try to save it from freeing all efs
 
@@ -97,6 +106,8 @@ CSCM_SA_FUNCS _cscm_sa_func_list[] = {
 	{0, cscm_is_cond, cscm_analyze_cond},
 	{0, cscm_is_begin, cscm_analyze_begin},
 	{0, cscm_is_let, cscm_analyze_let},
+	{0, cscm_is_letrec, cscm_analyze_letrec},
+	{0, cscm_is_do, cscm_analyze_do},
 	{0, cscm_is_ao, cscm_analyze_ao}, // and/or
 	{0, cscm_is_combination, cscm_analyze_combination},
 
@@ -127,162 +138,281 @@ CSCM_EF *cscm_analyze(CSCM_AST_NODE *exp)
 
 
 
-CSCM_OBJECT *cscm_apply(CSCM_OBJECT *proc, \
+/*	Bind the formal parameters of a compound procedure to args in
+ * frame, or in a new frame when frame is NULL, which is placed on the
+ * frame stack if flag_stacked is set. Arguments stored into the frame
+ * are cleared from args. */
+CSCM_OBJECT *_cscm_apply_frame(CSCM_OBJECT *frame,			\
+			int flag_stacked,				\
+			int flag_dtn,					\
+			size_t n_params, char **params,			\
+			size_t frame_size,				\
 			size_t n_args, CSCM_OBJECT **args)
 {
 	int i;
 
-	CSCM_OBJECT *ret;
+	size_t n_required_args;
+	CSCM_OBJECT **arguments;
 
-	int flag_tco_allow;
-	CSCM_PROC_PRIM_FUNC f;
 
-	CSCM_EF *body_ef;
-	CSCM_OBJECT *env;
-	size_t n_params;
-	char **params;
+	if (flag_dtn) { // at least 1 formal parameter
+		n_required_args = n_params - 1;
 
-	int flag_dtn;
-	size_t n_required_args;
-	CSCM_OBJECT **arguments;
+		if (n_args < n_required_args) {
+			cscm_error_report("cscm_apply", \
+					CSCM_ERROR_APPLY_N_ARGS);
+		} else if (n_args == n_required_args) {
+			arguments = cscm_object_ptrs_push(n_params);
 
-	CSCM_OBJECT *frame;
+			for (i = 0; i < n_required_args; i++)
+				arguments[i] = args[i];
 
-	CSCM_AST_NODE *exp;
+			arguments[i] = CSCM_NIL;
+		} else {
+			args[n_params - 1] =			\
+					cscm_list_create(	\
+					n_args - n_params + 1,	\
+					&args[n_params - 1]);
 
+			arguments = args;
+		}
+	} else {
+		if (n_args != n_params)
+			cscm_error_report("cscm_apply", \
+					CSCM_ERROR_APPLY_N_ARGS);
 
-	if (proc == NULL)
-		cscm_error_report("cscm_apply", \
-				CSCM_ERROR_APPLY_NO_PROC);
-	else if (n_args >= 1 && args == NULL)
-		cscm_error_report("cscm_apply", \
-				CSCM_ERROR_NULL_PTR);
+		arguments = args;
+	}
 
 
-	if (proc->type == CSCM_OBJECT_TYPE_PROC_PRIM) {
-		flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
-		cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+	if (frame) {
+		cscm_frame_reinit(frame, n_params, params, arguments);
+	} else {
+		if (flag_stacked)
+			frame = cscm_frame_create_stacked(frame_size);
+		else
+			frame = cscm_frame_create(frame_size);
 
+		if (n_params > 0)
+			cscm_frame_init(frame,		\
+					n_params,	\
+					params,		\
+					arguments);
+	}
 
-		f = cscm_proc_prim_get_f(proc);
-		ret = f(n_args, args);
+	if (arguments != args)
+		cscm_object_ptrs_pop(arguments);
 
 
-		if (ret) // try to save it from freeing arguments
-			cscm_gc_inc(ret);
+	/*	Arguments are counted by frame now, and the stack of
+	 * temporaries no longer needs them. */
+	for (i = 0; i < n_args; i++)
+		args[i] = NULL;
 
-		for (i = 0; i < n_args; i++)
-			cscm_gc_free(args[i]);
 
-		if (ret)
-			cscm_gc_dec(ret);
+	return frame;
+}
 
 
-		if (flag_tco_allow) // restore the original value of the flag
-			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
-	} else if (proc->type == CSCM_OBJECT_TYPE_PROC_COMP) {
-		body_ef = cscm_proc_comp_get_body(proc);
-		env = cscm_proc_comp_get_env(proc);
-		n_params = cscm_proc_comp_get_n_params(proc);
-		params = cscm_proc_comp_get_params(proc);
-		flag_dtn = cscm_proc_comp_get_flag_dtn(proc);
-
-
-		if (flag_dtn) { // at least 1 formal parameter
-			n_required_args = n_params - 1;
-
-			if (n_args < n_required_args) {
-				cscm_error_report("cscm_apply", \
-						CSCM_ERROR_APPLY_N_ARGS);
-			} else if (n_args == n_required_args) {
-				arguments = cscm_object_ptrs_create(n_params);
-
-				for (i = 0; i < n_required_args; i++)
-					arguments[i] = args[i];
-
-				arguments[i] = CSCM_NIL;
-			} else {
-				args[n_params - 1] =			\
-						cscm_list_create(	\
-						n_args - n_params + 1,	\
-						&args[n_params - 1]);
-
-				arguments = args;
-			}
-		} else {
-			if (n_args != n_params)
-				cscm_error_report("cscm_apply", \
-						CSCM_ERROR_APPLY_N_ARGS);
+/*	Return the counted environment where a compound procedure closed
+ * over outer is applied to args. A tail call from the body executed in
+ * tail_env reuses tail_env and its frame when nothing else can reach
+ * them, since that body has nothing left to do but this call. tail_env
+ * is NULL for other calls.
+ *	flag_stacked is set when the body of the procedure can not
+ * capture its environment, which is then placed on the frame stack
+ * for calls other than tail calls, since it is released before the
+ * call returns. An environment on the frame stack is only reused by
+ * such procedures, so that it is never captured. */
+CSCM_OBJECT *cscm_apply_env(CSCM_OBJECT *tail_env,			\
+			CSCM_OBJECT *outer,				\
+			int flag_dtn,					\
+			int flag_stacked,				\
+			size_t n_params, char **params,			\
+			size_t frame_size,				\
+			size_t n_args, CSCM_OBJECT **args)
+{
+	CSCM_OBJECT *env, *frame;
 
-			arguments = args;
-		}
 
+	/*	outer is tail_env itself when the procedure is bound by
+	 * letrec in the frame of tail_env. */
+	if (tail_env == NULL || tail_env == outer)
+		frame = NULL;
+	else if (!flag_stacked && cscm_mem_frame_has(tail_env))
+		frame = NULL;
+	else
+		frame = cscm_env_get_private_frame(tail_env, frame_size);
+
+	if (frame) {
+		_cscm_apply_frame(frame,		\
+				0,			\
+				flag_dtn,		\
+				n_params, params,	\
+				frame_size,		\
+				n_args, args);
+
+		cscm_env_set_outer(tail_env, outer);
+		env = tail_env;
+	} else {
+		flag_stacked = flag_stacked && tail_env == NULL;
+
+		frame = _cscm_apply_frame(NULL,			\
+					flag_stacked,		\
+					flag_dtn,		\
+					n_params, params,	\
+					frame_size,		\
+					n_args, args);
+
+		if (flag_stacked)
+			env = cscm_env_extend_stacked(outer, frame);
+		else
+			env = cscm_env_extend(outer, frame);
+	}
+
+	cscm_gc_inc(env);
 
-		frame = cscm_frame_create();
 
-		if (n_params > 0)
-			cscm_frame_init(frame,		\
-					n_params,	\
-					params,		\
-					arguments);
+	return env;
+}
 
-		if (arguments != args)
-			free(arguments);
 
-		env = cscm_env_cpy_extend(env, frame);
-		cscm_gc_inc(env);
+/*	Execute body_ef in env, which has been counted for the body and
+ * is released when the body returns. A body in a tail position is left
+ * to the loop below of an outer body by returning NULL, so that tail
+ * calls never grow the C stack. */
+CSCM_OBJECT *cscm_apply_body(CSCM_EF *body_ef, CSCM_OBJECT *env)
+{
+	CSCM_OBJECT *ret;
+	CSCM_AST_NODE *exp;
 
 
-		if (!cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW)) {
-			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
-		} else {
-			/* get current exp as the next exp */
-			exp = cscm_ef_backtrace_pop();
-			cscm_ef_backtrace_push(exp);
+	cscm_gc_check();
 
-			cscm_tco_state_save(env, body_ef, exp);
-			return NULL;
-		}
+
+	if (!cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW)) {
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+	} else {
+		/* get current exp as the next exp */
+		exp = cscm_ef_backtrace_pop();
+		cscm_ef_backtrace_push(exp);
+
+		cscm_tco_state_save(env, body_ef, exp);
+
+		return NULL;
+	}
+
+	ret = cscm_ef_exec(body_ef, env);
+
+
+	while (cscm_tco_get_flag(CSCM_TCO_FLAG_STATE_SAVED)) {
+		cscm_gc_dec(env);
+		cscm_gc_free(env);
+
+		cscm_tco_state_get(&env, &body_ef, &exp);
+
+		/* replace current exp with next exp*/
+		cscm_ef_backtrace_pop();
+		cscm_ef_backtrace_push(exp);
+
+		cscm_tco_unset_flag(CSCM_TCO_FLAG_STATE_SAVED);
 
 		ret = cscm_ef_exec(body_ef, env);
+	}
 
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
-		while (cscm_tco_get_flag(CSCM_TCO_FLAG_STATE_SAVED)) {
-			cscm_gc_dec(env);
-			cscm_gc_free(env);
 
-			cscm_tco_state_get(&env, &body_ef, &exp);
+	/* ret is left to the table if env was the last owner */
+	cscm_gc_dec(env);
+	cscm_gc_free(env);
 
-			/* replace current exp with next exp*/
-			cscm_ef_backtrace_pop();
-			cscm_ef_backtrace_push(exp);
 
-			cscm_tco_unset_flag(CSCM_TCO_FLAG_STATE_SAVED);
+	return ret;
+}
 
-			ret = cscm_ef_exec(body_ef, env);
-		}
 
+/*	The caller keeps proc and args in pointers from
+ * cscm_object_ptrs_push() until cscm_apply() returns, since they are
+ * not counted. Arguments stored into a frame are cleared from args. */
+CSCM_OBJECT *_cscm_apply(CSCM_OBJECT *proc,			\
+			size_t n_args, CSCM_OBJECT **args,	\
+			CSCM_OBJECT *tail_env)
+{
+	int i;
+
+	CSCM_OBJECT *ret;
+
+	int flag_tco_allow;
+	CSCM_PROC_PRIM_FUNC f;
+
+	CSCM_OBJECT *env;
+
+
+	if (proc == NULL)
+		cscm_error_report("cscm_apply", \
+				CSCM_ERROR_APPLY_NO_PROC);
+	else if (n_args >= 1 && args == NULL)
+		cscm_error_report("cscm_apply", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (CSCM_OBJECT_GET_TYPE(proc) == CSCM_OBJECT_TYPE_PROC_PRIM) {
+		flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
 		cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
 
-		if (ret) {
-			cscm_gc_inc(ret); // try to save it from freeing env
-			cscm_gc_dec(env);
-			cscm_gc_free(env);
-			cscm_gc_dec(ret);
-		} else {
-			cscm_gc_dec(env);
-			cscm_gc_free(env);
-		}
+		f = cscm_proc_prim_get_f(proc);
+		ret = f(n_args, args);
+
+
+		/*	ret can be one of the arguments, and objects released
+		 * with the others are left to the table. */
+		for (i = 0; i < n_args; i++)
+			if (args[i] != ret)
+				cscm_gc_free(args[i]);
+
+
+		if (flag_tco_allow) // restore the original value of the flag
+			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+		cscm_gc_free(proc);
+	} else if (CSCM_OBJECT_GET_TYPE(proc) == CSCM_OBJECT_TYPE_PROC_COMP) {
+		env = cscm_apply_env(tail_env,				     \
+				cscm_proc_comp_get_env(proc),		     \
+				cscm_proc_comp_get_flag_dtn(proc),	     \
+				cscm_proc_comp_get_flag_stacked(proc),	     \
+				cscm_proc_comp_get_n_params(proc),	     \
+				cscm_proc_comp_get_params(proc),	     \
+				cscm_proc_comp_get_frame_size(proc),	     \
+				n_args,					     \
+				args);
+
+
+		/*	proc is no longer needed, because env keeps the
+		 * environment of proc, and the body belongs to the lambda
+		 * expression rather than proc. However, it is freed after
+		 * the body returns, because the caller keeps it in the
+		 * stack of temporaries until then. */
+		ret = cscm_apply_body(cscm_proc_comp_get_body(proc), env);
+
+		cscm_gc_free(proc);
 	} else {
 		cscm_error_report("cscm_apply", CSCM_ERROR_OBJECT_TYPE);
 	}
 
 
-	cscm_gc_free(proc);
+	return ret;
+}
 
 
-	return ret;
+
+
+CSCM_OBJECT *cscm_apply(CSCM_OBJECT *proc, \
+			size_t n_args, CSCM_OBJECT **args)
+{
+	return _cscm_apply(proc, n_args, args, NULL);
 }
 
 
@@ -317,9 +447,14 @@ CSCM_COMBINATION_EF_STATE *_cscm_combination_ef_state_create()
 
 	state->proc_ef = NULL;
 
+	state->lambda_ef_ptr = NULL;
+	state->depth = 0;
+
 	state->n_arg_efs = 0;
 	state->arg_efs = NULL;
 
+	state->op = CSCM_BUILTIN_INLINE_NONE;
+
 
 	return state;
 }
@@ -332,7 +467,7 @@ CSCM_OBJECT *_cscm_combination_ef(void *state, CSCM_OBJECT *env)
 	CSCM_COMBINATION_EF_STATE *s;
 	int flag_tco_allow;
 
-	CSCM_OBJECT *proc, **args;
+	CSCM_OBJECT **temps, *proc, **args;
 
 	CSCM_OBJECT *ret;
 
@@ -344,30 +479,231 @@ CSCM_OBJECT *_cscm_combination_ef(void *state, CSCM_OBJECT *env)
 	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
 
+	/*	proc and args are not counted, so they are kept in the stack
+	 * of temporaries until cscm_apply() returns. */
+	temps = cscm_object_ptrs_push(1 + s->n_arg_efs);
+
 	proc = cscm_ef_exec(s->proc_ef, env);
+	temps[0] = proc;
 
+	args = s->n_arg_efs ? &temps[1] : NULL;
+	for (i = 0; i < s->n_arg_efs; i++)
+		args[i] = cscm_ef_exec(s->arg_efs[i], env);
 
-	if (s->n_arg_efs == 0) {
-		if (flag_tco_allow) // restore the original value of the flag
-			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
 
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
 
-		ret = cscm_apply(proc, 0, NULL);
-	} else {
-		args = cscm_object_ptrs_create(s->n_arg_efs);
-		for (i = 0; i < s->n_arg_efs; i++)
-			args[i] = cscm_ef_exec(s->arg_efs[i], env);
 
+	/* a tail call can reuse the environment of the current body */
+	ret = _cscm_apply(proc, s->n_arg_efs, args,	\
+			flag_tco_allow ? env : NULL);
 
-		if (flag_tco_allow) // restore the original value of the flag
-			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_object_ptrs_pop(temps);
+
+
+	return ret;
+}
+
+
+CSCM_OBJECT *_cscm_combination_ef_lambda(void *state, CSCM_OBJECT *env)
+{
+	int i;
+
+	CSCM_COMBINATION_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_LAMBDA_EF_STATE *lambda;
+	CSCM_OBJECT **args, *new_env;
+
+
+	s = (CSCM_COMBINATION_EF_STATE *)state;
+	lambda = (CSCM_LAMBDA_EF_STATE *)(*s->lambda_ef_ptr)->state;
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	args = s->n_arg_efs ? cscm_object_ptrs_push(s->n_arg_efs) : NULL;
+	for (i = 0; i < s->n_arg_efs; i++)
+		args[i] = cscm_ef_exec(s->arg_efs[i], env);
+
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	new_env = cscm_apply_env(flag_tco_allow ? env : NULL,		\
+				cscm_env_get_outer(env, s->depth),	\
+				lambda->flag_dtn,			\
+				lambda->flag_stacked,			\
+				lambda->n_params,			\
+				lambda->params,				\
+				lambda->frame_size,			\
+				s->n_arg_efs,				\
+				args);
+
+	if (args)
+		cscm_object_ptrs_pop(args);
+
+
+	return cscm_apply_body(lambda->body, new_env);
+}
+
+
+CSCM_OBJECT *_cscm_combination_ef_fixed(void *state, CSCM_OBJECT *env)
+{
+	int i;
+
+	CSCM_COMBINATION_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_OBJECT *temps[1 + CSCM_COMBINATION_MAX_FIXED_ARGS];
+
+	CSCM_OBJECT *ret;
+
+
+	s = (CSCM_COMBINATION_EF_STATE *)state;
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	/* slots are visited by collections before they are all set */
+	for (i = 0; i <= s->n_arg_efs; i++)
+		temps[i] = NULL;
+
+	cscm_gc_push_roots(temps, 1 + s->n_arg_efs);
+
+	temps[0] = cscm_ef_exec(s->proc_ef, env);
+
+	for (i = 0; i < s->n_arg_efs; i++)
+		temps[1 + i] = cscm_ef_exec(s->arg_efs[i], env);
+
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	ret = _cscm_apply(temps[0], s->n_arg_efs, &temps[1],	\
+			flag_tco_allow ? env : NULL);
 
+	cscm_gc_pop_roots();
 
-		ret = cscm_apply(proc, s->n_arg_efs, args);
 
-		free(args);
+	return ret;
+}
+
+
+CSCM_OBJECT *_cscm_combination_ef_lambda_fixed(void *state, CSCM_OBJECT *env)
+{
+	int i;
+
+	CSCM_COMBINATION_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_LAMBDA_EF_STATE *lambda;
+	CSCM_OBJECT *args[CSCM_COMBINATION_MAX_FIXED_ARGS], *new_env;
+
+
+	s = (CSCM_COMBINATION_EF_STATE *)state;
+	lambda = (CSCM_LAMBDA_EF_STATE *)(*s->lambda_ef_ptr)->state;
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	for (i = 0; i < s->n_arg_efs; i++)
+		args[i] = NULL;
+
+	if (s->n_arg_efs)
+		cscm_gc_push_roots(args, s->n_arg_efs);
+
+	for (i = 0; i < s->n_arg_efs; i++)
+		args[i] = cscm_ef_exec(s->arg_efs[i], env);
+
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	new_env = cscm_apply_env(flag_tco_allow ? env : NULL,		\
+				cscm_env_get_outer(env, s->depth),	\
+				lambda->flag_dtn,			\
+				lambda->flag_stacked,			\
+				lambda->n_params,			\
+				lambda->params,				\
+				lambda->frame_size,			\
+				s->n_arg_efs,				\
+				args);
+
+	if (s->n_arg_efs)
+		cscm_gc_pop_roots();
+
+
+	return cscm_apply_body(lambda->body, new_env);
+}
+
+
+
+
+/*	Combinations of two arguments whose operator is a global
+ * variable naming an arithmetic or comparison primitive. The operator
+ * is still evaluated, and the primitive is applied in place only if
+ * the variable is bound to it when the combination is evaluated, so
+ * redefining the variable falls back to cscm_apply(). */
+CSCM_OBJECT *_cscm_combination_ef_inline(void *state, CSCM_OBJECT *env)
+{
+	int i;
+
+	CSCM_COMBINATION_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_OBJECT *temps[3], *ret;
+
+
+	s = (CSCM_COMBINATION_EF_STATE *)state;
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	temps[0] = temps[1] = temps[2] = NULL;
+	cscm_gc_push_roots(temps, 3);
+
+	temps[0] = cscm_ef_exec(s->proc_ef, env);
+	temps[1] = cscm_ef_exec(s->arg_efs[0], env);
+	temps[2] = cscm_ef_exec(s->arg_efs[1], env);
+
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	if (temps[0] != NULL						\
+		&& CSCM_OBJECT_GET_TYPE(temps[0]) == CSCM_OBJECT_TYPE_PROC_PRIM	\
+		&& cscm_proc_prim_get_f(temps[0])			\
+			== cscm_builtin_inline_get_f(s->op)		\
+		&& (ret = cscm_builtin_inline_apply(s->op,		\
+						temps[1],		\
+						temps[2]))) {
+		/* the same as the primitive path of cscm_apply() */
+		for (i = 1; i < 3; i++)
+			if (temps[i] != ret)
+				cscm_gc_free(temps[i]);
+
+		cscm_gc_free(temps[0]);
+	} else {
+		ret = _cscm_apply(temps[0], 2, &temps[1],	\
+				flag_tco_allow ? env : NULL);
 	}
 
+	cscm_gc_pop_roots();
+
 
 	return ret;
 }
@@ -381,14 +717,44 @@ CSCM_EF *cscm_analyze_combination(CSCM_AST_NODE *exp)
 
 	CSCM_COMBINATION_EF_STATE *state;
 
+	CSCM_AST_NODE *operator;
 	CSCM_EF *proc_ef, **arg_efs;
+	CSCM_EF_FUNC f;
 
 
 	state = _cscm_combination_ef_state_create();
 
 
-	proc_ef = cscm_analyze(cscm_ast_exp_index(exp, 0));
-	state->proc_ef = proc_ef;
+	operator = cscm_ast_exp_index(exp, 0);
+	if (cscm_ast_is_symbol(operator) && cscm_is_var(operator))
+		state->lambda_ef_ptr = cscm_scope_resolve_proc(		\
+				cscm_symbol_intern_text(operator->text),	\
+				&state->depth);
+
+	if (state->lambda_ef_ptr) {
+		if (exp->n_childs - 1 <= CSCM_COMBINATION_MAX_FIXED_ARGS)
+			f = _cscm_combination_ef_lambda_fixed;
+		else
+			f = _cscm_combination_ef_lambda;
+	} else {
+		proc_ef = cscm_analyze(operator);
+		state->proc_ef = proc_ef;
+
+		if (exp->n_childs - 1 <= CSCM_COMBINATION_MAX_FIXED_ARGS)
+			f = _cscm_combination_ef_fixed;
+		else
+			f = _cscm_combination_ef;
+
+		if (exp->n_childs == 3					\
+			&& proc_ef->type == CSCM_EF_TYPE_VAR		\
+			&& ((CSCM_VAR_EF_STATE *)proc_ef->state)->addr	\
+				== CSCM_SCOPE_ADDR_GLOBAL) {
+			state->op = cscm_builtin_inline_find(operator->text);
+
+			if (state->op != CSCM_BUILTIN_INLINE_NONE)
+				f = _cscm_combination_ef_inline;
+		}
+	}
 
 
 	if (exp->n_childs == 1) {	// no argument in the combination
@@ -410,7 +776,7 @@ CSCM_EF *cscm_analyze_combination(CSCM_AST_NODE *exp)
 	return cscm_ef_construct(CSCM_EF_TYPE_COMBINATION,	\
 				state,				\
 				exp,				\
-				_cscm_combination_ef);
+				f);
 }
 
 
@@ -434,7 +800,8 @@ void cscm_combination_ef_free(CSCM_EF *ef)
 	state = (CSCM_COMBINATION_EF_STATE *)ef->state;
 
 
-	cscm_ef_free_tree(state->proc_ef);
+	if (state->proc_ef)
+		cscm_ef_free_tree(state->proc_ef);
 
 	for (i = 0; i < state->n_arg_efs; i++)
 		cscm_ef_free_tree(state->arg_efs[i]);
@@ -31,6 +31,7 @@
 #include "ef.h"
 #include "gc.h"
 #include "debug.h"
+#include "vm.h"
 #include "text.h"
 #include "cscheme.h"
 
@@ -49,6 +50,10 @@
 "options: -h\n"							\
 "         --docs\n"						\
 "         --debug\n"						\
+"         --gc-threshold=BYTES (0 disables cycle collections)\n"	\
+"         --gc-free-budget=OBJECTS (0 frees all objects at once)\n"	\
+"         --engine=ef|vm (execution functions or bytecode)\n"	\
+"         (--debug, --gc-* and --engine can be given in any order)\n" \
 "file: SCRIPT\n"						\
 "      -(STDIN)\n"						\
 "\nThere can be arguments for the script after \"file\"."
@@ -66,6 +71,70 @@ void cscm_print_usage()
 
 
 
+/*	Return 1 when arg is an option of garbage collections, or 0
+ * otherwise. */
+int cscm_handle_gc_option(char *arg)
+{
+	char *value;
+	void (*set)(size_t);
+
+
+	if (!strncmp(arg,					\
+			CSCM_GC_THRESHOLD_OPTION,		\
+			strlen(CSCM_GC_THRESHOLD_OPTION))) {
+		value = arg + strlen(CSCM_GC_THRESHOLD_OPTION);
+		set = cscm_gc_set_threshold;
+	} else if (!strncmp(arg,				\
+			CSCM_GC_FREE_BUDGET_OPTION,		\
+			strlen(CSCM_GC_FREE_BUDGET_OPTION))) {
+		value = arg + strlen(CSCM_GC_FREE_BUDGET_OPTION);
+		set = cscm_gc_set_free_budget;
+	} else {
+		return 0;
+	}
+
+
+	if (!cscm_text_is_integer(value) || atol(value) < 0)
+		cscm_error_report("cscm_handle_gc_option", \
+				CSCM_ERROR_CSCHEME_GC_OPTION);
+
+	set((size_t)atol(value));
+
+
+	return 1;
+}
+
+
+/*	Return 1 when arg selects the execution engine, or 0
+ * otherwise. */
+int cscm_handle_engine_option(char *arg)
+{
+	char *value;
+
+
+	if (strncmp(arg,					\
+			CSCM_VM_ENGINE_OPTION,			\
+			strlen(CSCM_VM_ENGINE_OPTION)))
+		return 0;
+
+
+	value = arg + strlen(CSCM_VM_ENGINE_OPTION);
+
+	if (!strcmp(value, CSCM_VM_ENGINE_VM))
+		cscm_vm_mode = 1;
+	else if (!strcmp(value, CSCM_VM_ENGINE_EF))
+		cscm_vm_mode = 0;
+	else
+		cscm_error_report("cscm_handle_engine_option", \
+				CSCM_ERROR_CSCHEME_ENGINE_OPTION);
+
+
+	return 1;
+}
+
+
+
+
 void cscm_print_basic_docs()
 {
 	puts("============ Basic Primitive Procedures ============");
@@ -319,9 +388,24 @@ int main(int argc, char *argv[])
 		cscm_gc_show_total_object_count("HANDLE-CLI-OPTIONS");
 	#endif
 
+	/* options which can come in any order before the script */
+	while (argc > 1) {
+		if (!strcmp(argv[1], "--debug"))
+			cscm_debug_mode = 1;
+		else if (!cscm_handle_gc_option(argv[1])	\
+			&& !cscm_handle_engine_option(argv[1]))
+			break;
+
+		argv[1] = argv[0];
+		argv++;
+		argc--;
+	}
+
+
 	flag_read_stdin = 0;
 	if (argc == 1 || !strcmp(argv[1], "-")) {
-		if (argc > 2)
+		/* the debugger reads its commands from stdin */
+		if (argc > 2 || cscm_debug_mode)
 			cscm_error_report("main", \
 					CSCM_ERROR_CSCHEME_ARGC);
 
@@ -331,11 +415,9 @@ int main(int argc, char *argv[])
 		flag_read_stdin = 1;
 
 
-		internal_argc = cscm_num_long_create();
-		cscm_num_long_set(internal_argc, 1);
+		internal_argc = cscm_num_long_create(1);
 
-		option_obj = cscm_symbol_create();
-		cscm_symbol_set(option_obj, "-");
+		option_obj = cscm_symbol_intern("-");
 
 		internal_argv = cscm_pair_create();
 		cscm_pair_set(internal_argv, option_obj, CSCM_NIL);
@@ -355,46 +437,6 @@ int main(int argc, char *argv[])
 		cscm_print_docs();
 
 		return 0;
-	} else if (!strcmp(argv[1], "--debug")) {
-		if (argc < 3)
-			cscm_error_report("main", \
-					CSCM_ERROR_CSCHEME_ARGC);
-
-
-		cscm_debug_mode = 1;
-
-
-		script = fopen(argv[2], "r");
-		if (script == NULL)
-			cscm_libc_fail("main", "fopen");
-	
-		script_name = argv[2];
-
-
-		internal_argc = cscm_num_long_create();
-		cscm_num_long_set(internal_argc, argc - 2);
-
-		option_objs = cscm_object_ptrs_create(argc - 2);
-		for (i = 2; i < argc; i++) {
-			option = argv[i];
-
-			if (cscm_text_is_integer(option)) {
-				option_obj = cscm_num_long_create();
-				cscm_num_long_set(option_obj, atol(option));
-			} else if (cscm_text_is_fpn(option)) {
-				option_obj = cscm_num_double_create();
-				cscm_num_double_set(option_obj, atof(option));
-			} else {
-				option_obj = cscm_symbol_create();
-				cscm_symbol_set(option_obj, option);
-			}
-
-			option_objs[i - 2] = option_obj;
-		}
-
-		internal_argv = cscm_list_create(argc - 2, option_objs);
-
-		free(option_objs);
 	} else {
 		script = fopen(argv[1], "r");
 		if (script == NULL)
@@ -403,22 +445,19 @@ int main(int argc, char *argv[])
 		script_name = argv[1];
 
 
-		internal_argc = cscm_num_long_create();
-		cscm_num_long_set(internal_argc, argc - 1);
+		internal_argc = cscm_num_long_create(argc - 1);
 
 		option_objs = cscm_object_ptrs_create(argc - 1);
 		for (i = 1; i < argc; i++) {
 			option = argv[i];
 
 			if (cscm_text_is_integer(option)) {
-				option_obj = cscm_num_long_create();
-				cscm_num_long_set(option_obj, atol(option));
+				option_obj = cscm_num_long_create(atol(option));
 			} else if (cscm_text_is_fpn(option)) {
 				option_obj = cscm_num_double_create();
 				cscm_num_double_set(option_obj, atof(option));
 			} else {
-				option_obj = cscm_symbol_create();
-				cscm_symbol_set(option_obj, option);
+				option_obj = cscm_symbol_intern(option);
 			}
 
 			option_objs[i - 1] = option_obj;
@@ -459,8 +498,8 @@ int main(int argc, char *argv[])
 	global_env = cscm_global_env_setup();
 	cscm_gc_inc(global_env);
 
-	cscm_env_add_var(global_env, "argc", internal_argc);
-	cscm_env_add_var(global_env, "argv", internal_argv);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("argc"), internal_argc);
+	cscm_env_add_var(global_env, cscm_symbol_intern_text("argv"), internal_argv);
 
 
 	#ifdef __CSCM_GC_DEBUG__
@@ -25,6 +25,7 @@
 #include "env.h"
 #include "object.h"
 #include "text.h"
+#include "symbol.h"
 #include "debug.h"
 
 
@@ -151,13 +152,15 @@ int _cscm_debug_cmd_handler_help(CSCM_OBJECT *env)
 
 int _cscm_debug_cmd_handler_print(CSCM_OBJECT *env)
 {
+	char *var;
 	CSCM_OBJECT *obj;
 	if (_cscm_debug_cmd_count != 2)
 		cscm_error_report("cscm_debug_cmd_handler_print", \
 				CSCM_ERROR_DEBUG_OPTION_N);
 
 
-	obj = cscm_env_get_var(env, _cscm_debug_cmd_vector[1]);
+	var = cscm_symbol_intern_text(_cscm_debug_cmd_vector[1]);
+	obj = cscm_env_get_var(env, var);
 
 	cscm_object_print(obj, stdout);
 	puts("");
@@ -247,7 +250,7 @@ int _cscm_debug_cmd_handler_frame(CSCM_OBJECT *env)
 		cscm_error_report("cscm_debug_cmd_handler_frame", \
 				CSCM_ERROR_DEBUG_CMD_FRAME_INDEX);
 
-	cscm_frame_print_details(real_env->frames[index], "");
+	cscm_frame_print_details(cscm_env_get_frame(env, index), "");
 
 
 	return CSCM_DEBUG_CMD_RET_CONTINUE;
@@ -22,12 +22,13 @@
 #include "object.h"
 #include "ef.h"
 #include "env.h"
-#include "text.h"
+#include "symbol.h"
 #include "core.h"
 #include "lambda.h"
 #include "num.h"
 #include "str.h"
 #include "var.h"
+#include "scope.h"
 #include "definition.h"
 
 
@@ -35,12 +36,12 @@
 
 int cscm_is_definition(CSCM_AST_NODE *exp)
 {
-	int i;
+	int i, j;
 
 	CSCM_AST_NODE *head;
 
 	CSCM_AST_NODE *var;
-	CSCM_AST_NODE *proc_part;
+	CSCM_AST_NODE *proc_part, *other;
 
 
 	if (exp == NULL)
@@ -85,6 +86,21 @@ int cscm_is_definition(CSCM_AST_NODE *exp)
 				cscm_syntax_error_report(var->filename,	\
 						var->line,		\
 						CSCM_ERROR_DEFINITION_BAD_VAR);
+
+			/*	Frames compare names by their addresses
+			 * and do not check duplications themselves. */
+			for (j = 1; j < i; j++) {
+				other = cscm_ast_exp_index(var, j);
+
+				if (cscm_ast_symbol_text_equal(proc_part, "."))
+					break;
+				else if (cscm_ast_symbol_text_equal(proc_part, \
+								other->text))
+					cscm_syntax_error_report(	\
+						var->filename,		\
+						var->line,		\
+						CSCM_ERROR_DEFINITION_DUP_PARAMS);
+			}
 		}
 
 
@@ -172,6 +188,10 @@ CSCM_EF *cscm_analyze_definition(CSCM_AST_NODE *exp)
 	CSCM_DEFINITION_EF_STATE *state;
 
 
+	/* definitions unknown to the current scope make it dynamic */
+	cscm_scope_check_definition(exp);
+
+
 	var = cscm_ast_exp_index(exp, 1);
 
 	if (cscm_ast_is_exp(var)) {	// define a new compound procedure
@@ -197,9 +217,9 @@ CSCM_EF *cscm_analyze_definition(CSCM_AST_NODE *exp)
 
 		/* Now, exp represents a lambda expression */
 		val_ef = cscm_analyze_lambda(new_lambda_exp);
-		var_text = cscm_text_cpy(new_var->text);
+		var_text = cscm_symbol_intern_text(new_var->text);
 	} else {			// define a new variable
-		var_text = cscm_text_cpy(var->text);
+		var_text = cscm_symbol_intern_text(var->text);
 
 		val = cscm_ast_exp_index(exp, 2);
 		val_ef = cscm_analyze(val);
@@ -235,8 +255,7 @@ void cscm_definition_ef_free(CSCM_EF *ef)
 
 	state = (CSCM_DEFINITION_EF_STATE *)ef->state;
 
-	free(state->var);
-	cscm_ef_free_tree(state->val_ef);
+	cscm_ef_free_tree(state->val_ef); // state->var is interned
 
 	free(state);
 
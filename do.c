@@ -0,0 +1,257 @@
+/* do.c -- scheme do expression(syntactic sugar)
+
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <stddef.h>
+
+#include "error.h"
+#include "ast.h"
+#include "ef.h"
+#include "num.h"
+#include "str.h"
+#include "var.h"
+#include "let.h"
+#include "do.h"
+
+
+
+
+/*	The name of the loop which do expressions are transformed
+ * into. It can not be written in any script, so it never shadows
+ * variables of the commands or the steps. */
+#define _CSCM_DO_LOOP_NAME	"do loop"
+
+
+
+
+/*	(do ((var init step) ...)
+ *	    (test expression ...)
+ *	  command ...)
+ * steps and commands are optional. */
+int cscm_is_do(CSCM_AST_NODE *exp)
+{
+	int i, j;
+
+	CSCM_AST_NODE *head;
+	CSCM_AST_NODE *var, *other, *binding, *bindings, *test_clause;
+
+
+	if (exp == NULL)
+		cscm_error_report("cscm_is_do", \
+				CSCM_ERROR_NULL_PTR);
+	else if (!cscm_ast_is_exp(exp))
+		return 0;
+	else if (cscm_ast_is_exp_empty(exp))
+		return 0;
+
+
+	head = cscm_ast_exp_index(exp, 0);
+	if (!cscm_ast_is_symbol(head))
+		return 0;
+	else if (!cscm_ast_symbol_text_equal(head, "do"))
+		return 0;
+
+
+	if (exp->n_childs == 1)
+		cscm_syntax_error_report(exp->filename,	\
+				exp->line,		\
+				CSCM_ERROR_DO_NO_BINDING);
+	else if (exp->n_childs == 2)
+		cscm_syntax_error_report(exp->filename,	\
+				exp->line,		\
+				CSCM_ERROR_DO_NO_TEST);
+
+
+	bindings = cscm_ast_exp_index(exp, 1);
+	if (!cscm_ast_is_exp(bindings))
+		cscm_syntax_error_report(bindings->filename,	\
+				bindings->line,			\
+				CSCM_ERROR_DO_BAD_BINDINGS);
+
+	for (i = 0; i < bindings->n_childs; i++) {
+		binding = cscm_ast_exp_index(bindings, i);
+
+		if (!cscm_ast_is_exp(binding))
+			cscm_syntax_error_report(binding->filename,	\
+					binding->line,			\
+					CSCM_ERROR_DO_BAD_BINDING);
+		else if (binding->n_childs != 2 && binding->n_childs != 3)
+			cscm_syntax_error_report(binding->filename,	\
+					binding->line,			\
+					CSCM_ERROR_DO_BAD_BINDING);
+
+		var = cscm_ast_exp_index(binding, 0);
+		if (cscm_is_num_long(var)		\
+			|| cscm_is_num_double(var)	\
+			|| cscm_is_string(var))
+			cscm_syntax_error_report(var->filename,		\
+					var->line,			\
+					CSCM_ERROR_DO_BAD_BINDING);
+		else if (!cscm_is_var(var))
+			cscm_syntax_error_report(var->filename,		\
+					var->line,			\
+					CSCM_ERROR_DO_BAD_BINDING);
+
+		for (j = 0; j < i; j++) {
+			other = cscm_ast_exp_index(			\
+					cscm_ast_exp_index(bindings, j), 0);
+
+			if (cscm_ast_symbol_text_equal(var, other->text))
+				cscm_syntax_error_report(var->filename,	\
+						var->line,		\
+						CSCM_ERROR_DO_DUP_VARS);
+		}
+	}
+
+
+	test_clause = cscm_ast_exp_index(exp, 2);
+	if (!cscm_ast_is_exp(test_clause))
+		cscm_syntax_error_report(test_clause->filename,	\
+				test_clause->line,		\
+				CSCM_ERROR_DO_BAD_TEST);
+	else if (cscm_ast_is_exp_empty(test_clause))
+		cscm_syntax_error_report(test_clause->filename,	\
+				test_clause->line,		\
+				CSCM_ERROR_DO_BAD_TEST);
+
+
+	return 1;
+}
+
+
+
+
+CSCM_AST_NODE *_cscm_do_symbol_create(char *text)
+{
+	CSCM_AST_NODE *symbol;
+
+
+	symbol = cscm_ast_symbol_create("<transformation>", 0);
+	cscm_ast_symbol_set(symbol, text);
+
+
+	return symbol;
+}
+
+
+/*	(do ((var init step) ...) (test expression ...) command ...)
+ * is transformed into
+ *	(let <loop> ((var init) ...)
+ *	  (if test
+ *	      (begin expression ...)
+ *	      (begin command ... (<loop> step ...))))
+ * where a variable without step is passed to <loop> as it is, and
+ * the value is unspecified when there is no expression. */
+CSCM_EF *cscm_analyze_do(CSCM_AST_NODE *exp)
+{
+	int i;
+
+	CSCM_AST_NODE *binding, *bindings, *test_clause;
+	CSCM_AST_NODE *var, *step;
+
+	CSCM_AST_NODE *let, *let_bindings, *let_binding;
+	CSCM_AST_NODE *if_exp, *result, *loop, *call, *unspecified;
+
+
+	cscm_ast_free_symbol(cscm_ast_exp_index(exp, 0)); // symbol: "do"
+
+
+	let_bindings = cscm_ast_exp_create("<transformation>", 0);
+
+	call = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(call, _cscm_do_symbol_create(_CSCM_DO_LOOP_NAME));
+
+	bindings = cscm_ast_exp_index(exp, 1);
+	for (i = 0; i < bindings->n_childs; i++) {
+		binding = cscm_ast_exp_index(bindings, i);
+
+		var = cscm_ast_exp_index(binding, 0);
+
+		if (binding->n_childs == 3)
+			step = cscm_ast_exp_index(binding, 2);
+		else
+			step = _cscm_do_symbol_create(var->text);
+
+		cscm_ast_exp_append(call, step);
+
+
+		let_binding = cscm_ast_exp_create("<transformation>", 0);
+		cscm_ast_exp_append(let_binding, var);
+		cscm_ast_exp_append(let_binding, cscm_ast_exp_index(binding, 1));
+
+		cscm_ast_exp_append(let_bindings, let_binding);
+
+
+		cscm_ast_free_exp(binding);
+	}
+
+	cscm_ast_free_exp(bindings);
+
+
+	/* constructing the loop: (begin command ... (<loop> step ...)) */
+	loop = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(loop, _cscm_do_symbol_create("begin"));
+
+	for (i = 3; i < exp->n_childs; i++)
+		cscm_ast_exp_append(loop, cscm_ast_exp_index(exp, i));
+
+	cscm_ast_exp_append(loop, call);
+
+
+	/* constructing the result: (begin expression ...) */
+	test_clause = cscm_ast_exp_index(exp, 2);
+
+	if (test_clause->n_childs == 1) {
+		unspecified = cscm_ast_exp_create("<transformation>", 0);
+		cscm_ast_exp_append(unspecified, _cscm_do_symbol_create("if"));
+		cscm_ast_exp_append(unspecified, _cscm_do_symbol_create("#f"));
+		cscm_ast_exp_append(unspecified, _cscm_do_symbol_create("#f"));
+
+		result = unspecified;
+	} else {
+		result = cscm_ast_exp_create("<transformation>", 0);
+		cscm_ast_exp_append(result, _cscm_do_symbol_create("begin"));
+
+		for (i = 1; i < test_clause->n_childs; i++)
+			cscm_ast_exp_append(result,			\
+					cscm_ast_exp_index(test_clause, i));
+	}
+
+
+	if_exp = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(if_exp, _cscm_do_symbol_create("if"));
+	cscm_ast_exp_append(if_exp, cscm_ast_exp_index(test_clause, 0));
+	cscm_ast_exp_append(if_exp, result);
+	cscm_ast_exp_append(if_exp, loop);
+
+	cscm_ast_free_exp(test_clause);
+
+
+	let = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(let, _cscm_do_symbol_create("let"));
+	cscm_ast_exp_append(let, _cscm_do_symbol_create(_CSCM_DO_LOOP_NAME));
+	cscm_ast_exp_append(let, let_bindings);
+	cscm_ast_exp_append(let, if_exp);
+
+
+	/*	Move the new expression to exp, so that it will be freed
+	 * with the original ast tree. */
+	cscm_ast_exp_mv(let, exp);
+
+
+	return cscm_analyze_let(exp);
+}
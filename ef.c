@@ -34,6 +34,8 @@
 #include "core.h"
 #include "quote.h"
 #include "quasiquote.h"
+#include "let.h"
+#include "vm.h"
 #include "ast.h"
 #include "debug.h"
 #include "ef.h"
@@ -183,7 +185,10 @@ CSCM_EF_FREE_FUNC _cscm_ef_free_func_list[] = {
 	cscm_if_ef_free,
 	cscm_seq_ef_free,
 	cscm_ao_ef_free,
-	cscm_combination_ef_free
+	cscm_combination_ef_free,
+	cscm_let_ef_free,
+	cscm_lambda_body_ef_free,
+	cscm_vm_ef_free
 };
 
 
@@ -27,42 +27,206 @@
 #include "proc.h"
 #include "gc.h"
 #include "builtin.h"
+#include "symbol.h"
+#include "cell.h"
 #include "env.h"
 
 
 
 
-/* There is only one copy of **UNASSIGNED** in cscheme */
-CSCM_OBJECT _cscm_unassigned = {CSCM_OBJECT_TYPE_UNASSIGNED, NULL, 0};
-
-
-
-
-CSCM_OBJECT *cscm_frame_create()
+/*	size is the number of bindings expected to be held by the
+ * frame. CSCM_FRAME is stored inline in the object, and variables
+ * and values are stored right behind it in the same memory block.
+ * They will be moved to a separate block when the frame grows. */
+CSCM_OBJECT *_cscm_frame_create(size_t size, int flag_stacked)
 {
+	size_t n_bytes;
+
 	CSCM_OBJECT *obj;
 	CSCM_FRAME *frame;
 
 
-	obj = cscm_object_create();
+	n_bytes = sizeof(CSCM_FRAME)					\
+		+ size * (sizeof(char *) + sizeof(CSCM_OBJECT *));
+
+	if (flag_stacked)
+		obj = cscm_object_create_inline_stacked(n_bytes);
+	else
+		obj = cscm_object_create_inline(n_bytes);
 
 
 	obj->type = CSCM_OBJECT_TYPE_FRAME;
 
 
-	frame = malloc(sizeof(CSCM_FRAME));
-	if (frame == NULL)
-		cscm_libc_fail("cscm_frame_create", "malloc");
+	frame = (CSCM_FRAME *)obj->value;
 
 	frame->n_bindings = 0;
+	frame->size = size;
+	frame->inline_size = size;
 
-	obj->value = frame;
+	frame->vars = (char **)(frame + 1);
+	frame->vals = (CSCM_OBJECT **)(frame->vars + size);
+
+	frame->index = NULL;
 
 
 	return obj;
 }
 
 
+CSCM_OBJECT *cscm_frame_create(size_t size)
+{
+	return _cscm_frame_create(size, 0);
+}
+
+
+/*	The frame is placed on the frame stack, see
+ * cscm_object_create_inline_stacked(). */
+CSCM_OBJECT *cscm_frame_create_stacked(size_t size)
+{
+	return _cscm_frame_create(size, 1);
+}
+
+
+/*	Bind vals[i] to val, or store val into the cell bound to
+ * vals[i], which is shared by closures capturing the variable. */
+void _cscm_frame_store(CSCM_FRAME *frame, size_t i, CSCM_OBJECT *val)
+{
+	if (CSCM_CELL_IS(frame->vals[i])) {
+		cscm_cell_set(frame->vals[i], val);
+		return;
+	}
+
+
+	cscm_gc_inc(val); // before the old value is released
+	cscm_gc_dec(frame->vals[i]);
+	cscm_gc_free(frame->vals[i]);
+
+	frame->vals[i] = val;
+}
+
+
+void _cscm_frame_grow(CSCM_FRAME *frame, size_t size)
+{
+	int i;
+
+	char **vars;
+	CSCM_OBJECT **vals;
+
+
+	vars = malloc(size * (sizeof(char *) + sizeof(CSCM_OBJECT *)));
+	if (vars == NULL)
+		cscm_libc_fail("_cscm_frame_grow", "malloc");
+
+	vals = (CSCM_OBJECT **)(vars + size);
+
+
+	for (i = 0; i < frame->n_bindings; i++) {
+		vars[i] = frame->vars[i];
+		vals[i] = frame->vals[i];
+	}
+
+
+	if (frame->vars != (char **)(frame + 1))
+		free(frame->vars);
+
+	frame->vars = vars;
+	frame->vals = vals;
+
+	frame->size = size;
+}
+
+
+
+
+/* multiplicative hashing of the address of an interned name */
+#define _CSCM_FRAME_INDEX_HASH(var)	(((size_t)(var) >> 4) * 2654435761u)
+
+
+void _cscm_frame_index_insert(CSCM_FRAME *frame, size_t i)
+{
+	size_t index, mask;
+	size_t *entries;
+
+
+	mask = frame->index->size - 1;
+	entries = frame->index->entries;
+
+	index = _CSCM_FRAME_INDEX_HASH(frame->vars[i]) & mask;
+	while (entries[index])
+		index = (index + 1) & mask;
+
+	entries[index] = i + 1;
+}
+
+
+/*	(Re)build the index of all bindings of the frame, growing it
+ * so as to keep the load factor below 1/2. */
+void _cscm_frame_index_build(CSCM_FRAME *frame)
+{
+	int i;
+	size_t size;
+
+
+	if (frame->index)
+		size = frame->index->size;
+	else
+		size = CSCM_FRAME_INDEX_INIT_SIZE;
+
+	while (2 * (frame->n_bindings + 1) > size)
+		size *= 2;
+
+
+	if (frame->index == NULL || frame->index->size != size) {
+		if (frame->index)
+			free(frame->index);
+
+		frame->index = malloc(sizeof(CSCM_FRAME_INDEX)	\
+					+ size * sizeof(size_t));
+		if (frame->index == NULL)
+			cscm_libc_fail("_cscm_frame_index_build", "malloc");
+
+		frame->index->size = size;
+		frame->index->entries = (size_t *)(frame->index + 1);
+	}
+
+	memset(frame->index->entries, 0, size * sizeof(size_t));
+
+
+	for (i = 0; i < frame->n_bindings; i++)
+		_cscm_frame_index_insert(frame, i);
+}
+
+
+/*	Return the position of var in the frame, or n_bindings when
+ * var is not bound in the frame. */
+size_t _cscm_frame_find(CSCM_FRAME *frame, char *var)
+{
+	size_t i, mask, entry;
+
+
+	if (frame->index == NULL) {
+		for (i = 0; i < frame->n_bindings; i++)
+			if (var == frame->vars[i])
+				return i;
+
+		return frame->n_bindings;
+	}
+
+
+	mask = frame->index->size - 1;
+
+	for (i = _CSCM_FRAME_INDEX_HASH(var) & mask; ; i = (i + 1) & mask) {
+		entry = frame->index->entries[i];
+
+		if (entry == 0)
+			return frame->n_bindings;
+		else if (var == frame->vars[entry - 1])
+			return entry - 1;
+	}
+}
+
+
 
 
 void cscm_frame_init(CSCM_OBJECT *frame_obj, \
@@ -75,7 +239,7 @@ void cscm_frame_init(CSCM_OBJECT *frame_obj, \
 	if (frame_obj == NULL)
 		cscm_error_report("cscm_frame_init", \
 				CSCM_ERROR_NULL_PTR);
-	else if (frame_obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_init", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (frame_obj->value == NULL)
@@ -87,18 +251,16 @@ void cscm_frame_init(CSCM_OBJECT *frame_obj, \
 	if (frame->n_bindings != 0)
 		cscm_error_report("cscm_frame_init", \
 				CSCM_ERROR_FRAME_NOT_EMPTY);
-	else if (n > CSCM_FRAME_MAX_SIZE)
-		cscm_error_report("cscm_frame_init", \
-				CSCM_ERROR_FRAME_TOO_MANY_VARS);
 	else if (vars == NULL || n == 0)
 		cscm_error_report("cscm_frame_init", \
 				CSCM_ERROR_FRAME_NO_VAR);
 	else if (vals == NULL)
 		cscm_error_report("cscm_frame_init", \
 				CSCM_ERROR_FRAME_NO_VAL);
-	else if (!cscm_text_unique(n, vars))
-		cscm_error_report("cscm_frame_init", \
-				CSCM_ERROR_FRAME_NOT_UNIQUE);
+
+
+	if (n > frame->size)
+		_cscm_frame_grow(frame, n);
 
 
 
@@ -112,7 +274,7 @@ void cscm_frame_init(CSCM_OBJECT *frame_obj, \
 					CSCM_ERROR_FRAME_NO_VAL);
 
 
-		frame->vars[i] = cscm_text_cpy(vars[i]);
+		frame->vars[i] = vars[i];
 
 
 		frame->vals[i] = vals[i];
@@ -129,14 +291,14 @@ void cscm_frame_init(CSCM_OBJECT *frame_obj, \
 // add when not exists, set when exists.
 void cscm_frame_add_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
 {
-	int i;
+	size_t i;
 	CSCM_FRAME *frame;
 
 
 	if (frame_obj == NULL)
 		cscm_error_report("cscm_frame_add_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (frame_obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_add_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (frame_obj->value == NULL)
@@ -153,25 +315,22 @@ void cscm_frame_add_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
 	frame = (CSCM_FRAME *)frame_obj->value;
 
 
-	for (i = 0; i < frame->n_bindings; i++) {
-		if (!strcmp(var, frame->vars[i])) {
-			cscm_gc_dec(frame->vals[i]);
-			cscm_gc_free(frame->vals[i]);
-
-			frame->vals[i] = val;
-			cscm_gc_inc(val);
-
-			return;
-		}
+	i = _cscm_frame_find(frame, var);
+	if (i < frame->n_bindings) {
+		_cscm_frame_store(frame, i, val);
+		return;
 	}
 
 
-	if (frame->n_bindings >= CSCM_FRAME_MAX_SIZE)
-		cscm_error_report("cscm_frame_add_var", \
-				CSCM_ERROR_FRAME_FULL);
+	if (frame->n_bindings >= frame->size) {
+		if (frame->size == 0)
+			_cscm_frame_grow(frame, CSCM_FRAME_INIT_SIZE);
+		else
+			_cscm_frame_grow(frame, 2 * frame->size);
+	}
 
 
-	frame->vars[frame->n_bindings] = cscm_text_cpy(var);
+	frame->vars[frame->n_bindings] = var;
 
 
 	frame->vals[frame->n_bindings] = val;
@@ -179,6 +338,13 @@ void cscm_frame_add_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
 
 
 	frame->n_bindings++;
+
+	if (frame->index == NULL)
+		return;
+	else if (2 * (frame->n_bindings + 1) > frame->index->size)
+		_cscm_frame_index_build(frame);
+	else
+		_cscm_frame_index_insert(frame, frame->n_bindings - 1);
 }
 
 
@@ -190,14 +356,16 @@ void cscm_frame_add_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
  * means the specified variable is not existed in this frame. */
 CSCM_OBJECT *cscm_frame_get_var(CSCM_OBJECT *frame_obj, char *var)
 {
-	int i;
+	size_t i;
 	CSCM_FRAME *frame;
 
+	CSCM_OBJECT *val;
+
 
 	if (frame_obj == NULL)
 		cscm_error_report("cscm_frame_get_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (frame_obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_get_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (frame_obj->value == NULL)
@@ -211,21 +379,24 @@ CSCM_OBJECT *cscm_frame_get_var(CSCM_OBJECT *frame_obj, char *var)
 	frame = (CSCM_FRAME *)frame_obj->value;
 
 
-	for (i = 0; i < frame->n_bindings; i++) {
-		if (!strcmp(var, frame->vars[i])) {
-			if (frame->vals[i] == CSCM_UNASSIGNED)
-				cscm_runtime_error_report(var, \
-						CSCM_ERROR_FRAME_UNASSIGNED);
-			else if (frame->vals[i] == NULL)
-				cscm_error_report("cscm_frame_get_var", \
-						CSCM_ERROR_FRAME_EMPTY_BINDING);
-			else
-				return frame->vals[i];
-		}
-	}
+	i = _cscm_frame_find(frame, var);
+	if (i == frame->n_bindings)
+		return NULL;
+
+
+	val = frame->vals[i];
+	if (val && CSCM_CELL_IS(val))
+		val = CSCM_CELL_GET(val);
+
+	if (val == CSCM_UNASSIGNED)
+		cscm_runtime_error_report(var, \
+				CSCM_ERROR_FRAME_UNASSIGNED);
+	else if (val == NULL)
+		cscm_error_report("cscm_frame_get_var", \
+				CSCM_ERROR_FRAME_EMPTY_BINDING);
 
 
-	return NULL;
+	return val;
 }
 
 
@@ -233,14 +404,14 @@ CSCM_OBJECT *cscm_frame_get_var(CSCM_OBJECT *frame_obj, char *var)
 
 void cscm_frame_set_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
 {
-	int i;
+	size_t i;
 	CSCM_FRAME *frame;
 
 
 	if (frame_obj == NULL)
 		cscm_error_report("cscm_frame_set_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (frame_obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_set_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (frame_obj->value == NULL)
@@ -257,109 +428,427 @@ void cscm_frame_set_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val)
 	frame = (CSCM_FRAME *)frame_obj->value;
 
 
+	i = _cscm_frame_find(frame, var);
+	if (i == frame->n_bindings)
+		cscm_runtime_error_report(var, CSCM_ERROR_FRAME_UNBOUND);
+
+
+	_cscm_frame_store(frame, i, val);
+}
+
+
+/*	Replace all bindings of the frame with n variables bound to
+ * vals, like an empty frame initialized by cscm_frame_init(). */
+void cscm_frame_reinit(CSCM_OBJECT *frame_obj, \
+		size_t n, char **vars, CSCM_OBJECT **vals)
+{
+	int i;
+	CSCM_FRAME *frame;
+
+
+	if (frame_obj == NULL)
+		cscm_error_report("cscm_frame_reinit", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
+		cscm_error_report("cscm_frame_reinit", \
+				CSCM_ERROR_OBJECT_TYPE);
+	else if (frame_obj->value == NULL)
+		cscm_error_report("cscm_frame_reinit", \
+				CSCM_ERROR_EMPTY_OBJECT);
+	else if (n > 0 && (vars == NULL || vals == NULL))
+		cscm_error_report("cscm_frame_reinit", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	frame = (CSCM_FRAME *)frame_obj->value;
+
+
+	/* new values can be old values */
+	for (i = 0; i < n; i++) {
+		if (vars[i] == NULL || *(vars[i]) == 0)
+			cscm_error_report("cscm_frame_reinit", \
+					CSCM_ERROR_FRAME_NO_VAR);
+		else if (vals[i] == NULL)
+			cscm_error_report("cscm_frame_reinit", \
+					CSCM_ERROR_FRAME_NO_VAL);
+
+		cscm_gc_inc(vals[i]);
+	}
+
 	for (i = 0; i < frame->n_bindings; i++) {
-		if (!strcmp(var, frame->vars[i])) {
-			cscm_gc_dec(frame->vals[i]);
-			cscm_gc_free(frame->vals[i]);
+		cscm_gc_dec(frame->vals[i]);
+		cscm_gc_free(frame->vals[i]);
+	}
 
-			frame->vals[i] = val;
-			cscm_gc_inc(val);
+	frame->n_bindings = 0;
 
-			return;
-		}
+
+	if (n > frame->size)
+		_cscm_frame_grow(frame, n);
+
+	for (i = 0; i < n; i++) {
+		frame->vars[i] = vars[i];
+		frame->vals[i] = vals[i];
 	}
 
+	frame->n_bindings = n;
+
 
-	cscm_runtime_error_report(var, CSCM_ERROR_FRAME_UNBOUND);
+	if (frame->index)
+		_cscm_frame_index_build(frame);
 }
 
 
+/*	Put the values bound in slots into cells, see cell.h. Slots
+ * which have not been bound yet, i.e. variables of internal definitions,
+ * are bound to **UNASSIGNED** in the order of vars first, so that
+ * closures created before the definitions share their cells. */
+void cscm_frame_make_cells(CSCM_OBJECT *frame_obj,				size_t n, size_t *slots,				char **vars)
+{
+	int i;
+	size_t last;
+	CSCM_FRAME *frame;
 
+	CSCM_OBJECT *val, *cell;
 
 
-CSCM_OBJECT *cscm_env_create()
+	if (frame_obj == NULL || slots == NULL || vars == NULL)
+		cscm_error_report("cscm_frame_make_cells", \
+				CSCM_ERROR_NULL_PTR);
+	else if (n == 0)
+		return;
+
+
+	frame = (CSCM_FRAME *)frame_obj->value;
+
+
+	last = slots[n - 1];
+
+	if (last >= frame->size)
+		_cscm_frame_grow(frame, last + 1);
+
+	for (i = frame->n_bindings; i <= last; i++) {
+		frame->vars[i] = vars[i];
+		frame->vals[i] = CSCM_UNASSIGNED;
+	}
+
+	if (frame->n_bindings <= last) {
+		frame->n_bindings = last + 1;
+
+		if (frame->index)
+			_cscm_frame_index_build(frame);
+	}
+
+
+	for (i = 0; i < n; i++) {
+		val = frame->vals[slots[i]];
+		if (CSCM_CELL_IS(val))
+			continue;
+
+		/* the reference of the frame is moved to the cell */
+		cell = cscm_cell_create(val);
+		cscm_gc_dec(val);
+
+		cscm_gc_inc(cell);
+		frame->vals[slots[i]] = cell;
+	}
+}
+
+
+
+
+void cscm_frame_index(CSCM_OBJECT *frame_obj)
+{
+	CSCM_FRAME *frame;
+
+
+	if (frame_obj == NULL)
+		cscm_error_report("cscm_frame_index", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
+		cscm_error_report("cscm_frame_index", \
+				CSCM_ERROR_OBJECT_TYPE);
+
+
+	frame = (CSCM_FRAME *)frame_obj->value;
+
+	if (frame->index == NULL)
+		_cscm_frame_index_build(frame);
+}
+
+
+
+
+/*	Return the cell bound to var, putting the value into a cell
+ * first as cscm_frame_make_cells() does, or NULL when var is not bound
+ * in the frame. The cell stays bound to var until the frame is freed,
+ * so callers can keep it to read the current value of var. */
+CSCM_OBJECT *cscm_frame_get_cell(CSCM_OBJECT *frame_obj, char *var)
+{
+	size_t i;
+	CSCM_FRAME *frame;
+
+	CSCM_OBJECT *val, *cell;
+
+
+	if (frame_obj == NULL)
+		cscm_error_report("cscm_frame_get_cell", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(frame_obj) != CSCM_OBJECT_TYPE_FRAME)
+		cscm_error_report("cscm_frame_get_cell", \
+				CSCM_ERROR_OBJECT_TYPE);
+	else if (var == NULL || *var == 0)
+		cscm_error_report("cscm_frame_get_cell", \
+				CSCM_ERROR_FRAME_NO_VAR);
+
+
+	frame = (CSCM_FRAME *)frame_obj->value;
+
+
+	i = _cscm_frame_find(frame, var);
+	if (i == frame->n_bindings)
+		return NULL;
+
+
+	val = frame->vals[i];
+	if (val == NULL)
+		cscm_error_report("cscm_frame_get_cell", \
+				CSCM_ERROR_FRAME_EMPTY_BINDING);
+	else if (CSCM_CELL_IS(val))
+		return val;
+
+
+	/* the reference of the frame is moved to the cell */
+	cell = cscm_cell_create(val);
+	cscm_gc_dec(val);
+
+	cscm_gc_inc(cell);
+	frame->vals[i] = cell;
+
+
+	return cell;
+}
+
+
+
+
+CSCM_OBJECT *_cscm_env_create(int flag_stacked)
 {
 	CSCM_OBJECT *obj;
 	CSCM_ENV *env;
 
 
-	obj = cscm_object_create();
+	if (flag_stacked)
+		obj = cscm_object_create_inline_stacked(sizeof(CSCM_ENV));
+	else
+		obj = cscm_object_create_inline(sizeof(CSCM_ENV));
 
 
 	obj->type = CSCM_OBJECT_TYPE_ENV;
 
 
-	env = malloc(sizeof(CSCM_ENV));
-	if (env == NULL)
-		cscm_libc_fail("cscm_env_create", "malloc");
+	env = (CSCM_ENV *)obj->value;
 
 	env->n_frames = 0;
-	env->frames = NULL;
 
-	obj->value = env;
+	env->frame = NULL;
+	env->outer = NULL;
 
 
 	return obj;
 }
 
 
+CSCM_OBJECT *cscm_env_create()
+{
+	return _cscm_env_create(0);
+}
 
 
-CSCM_OBJECT *cscm_env_cpy_extend(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame)
-{
-	int i;
 
+
+/*	The new environment refers to env_obj as its outer one instead
+ * of copying all its frames, so extending takes constant time. */
+CSCM_OBJECT *_cscm_env_extend(CSCM_OBJECT *env_obj,	\
+			CSCM_OBJECT *frame,		\
+			int flag_stacked)
+{
 	CSCM_ENV *env, *new_env;
 
 	CSCM_OBJECT *new_env_obj;
 
-	CSCM_OBJECT **frames_buf;
-
 
 	if (env_obj == NULL)
-		cscm_error_report("cscm_env_cpy_extend", \
+		cscm_error_report("cscm_env_extend", \
 				CSCM_ERROR_NULL_PTR);
-	else if (env_obj->type != CSCM_OBJECT_TYPE_ENV)
-		cscm_error_report("cscm_env_cpy_extend", \
+	else if (CSCM_OBJECT_GET_TYPE(env_obj) != CSCM_OBJECT_TYPE_ENV)
+		cscm_error_report("cscm_env_extend", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (env_obj->value == NULL)
-		cscm_error_report("cscm_env_cpy_extend", \
+		cscm_error_report("cscm_env_extend", \
 				CSCM_ERROR_EMPTY_OBJECT);
 
 
 	env = (CSCM_ENV *)env_obj->value;
 	if (env->n_frames == 0)
-		cscm_error_report("cscm_env_cpy_extend", \
+		cscm_error_report("cscm_env_extend", \
 				CSCM_ERROR_ENV_EMPTY);
-	else if (frame->type != CSCM_OBJECT_TYPE_FRAME)
-		cscm_error_report("cscm_env_cpy_extend", \
+	else if (CSCM_OBJECT_GET_TYPE(frame) != CSCM_OBJECT_TYPE_FRAME)
+		cscm_error_report("cscm_env_extend", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	new_env_obj = cscm_env_create();
+	new_env_obj = _cscm_env_create(flag_stacked);
 	new_env = (CSCM_ENV *)new_env_obj->value;
 
 
 	new_env->n_frames = env->n_frames + 1;
 
+	new_env->frame = frame;
+	cscm_gc_inc(frame);
 
-	frames_buf = cscm_object_ptrs_create(env->n_frames + 1);
+	new_env->outer = env_obj;
+	cscm_gc_inc(env_obj);
 
 
-	for (i = 1; i < new_env->n_frames; i++) {
-		frames_buf[i] = env->frames[i - 1];
-		cscm_gc_inc(frames_buf[i]);
+	return new_env_obj;
+}
+
+
+CSCM_OBJECT *cscm_env_extend(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame)
+{
+	return _cscm_env_extend(env_obj, frame, 0);
+}
+
+
+/*	The new environment is placed on the frame stack, see
+ * cscm_object_create_inline_stacked(). */
+CSCM_OBJECT *cscm_env_extend_stacked(CSCM_OBJECT *env_obj,	\
+				CSCM_OBJECT *frame)
+{
+	return _cscm_env_extend(env_obj, frame, 1);
+}
+
+
+
+
+/* depth 0 is env_obj itself */
+CSCM_OBJECT *cscm_env_get_outer(CSCM_OBJECT *env_obj, size_t depth)
+{
+	CSCM_ENV *env;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_outer", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	if (depth >= env->n_frames)
+		cscm_error_report("cscm_env_get_outer", \
+				CSCM_ERROR_ENV_BAD_DEPTH);
+
+
+	for (; depth > 0; depth--) {
+		env_obj = env->outer;
+		env = (CSCM_ENV *)env_obj->value;
 	}
 
 
-	frames_buf[0] = frame;
-	cscm_gc_inc(frame);
+	return env_obj;
+}
+
+
+/*	Return the innermost frame when it can only be reached through
+ * env_obj, and env_obj is referenced only once, or NULL otherwise.
+ * The global environment is never private. Frames without room for
+ * size bindings are not returned either, since they would have to
+ * grow. */
+CSCM_OBJECT *cscm_env_get_private_frame(CSCM_OBJECT *env_obj, size_t size)
+{
+	CSCM_ENV *env;
+	CSCM_FRAME *frame;
 
 
-	new_env->frames = frames_buf;
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_private_frame", \
+				CSCM_ERROR_NULL_PTR);
 
 
-	return new_env_obj;
+	env = (CSCM_ENV *)env_obj->value;
+
+	if (env->outer == NULL)
+		return NULL;
+	else if (env_obj->ref_count != 1 || env->frame->ref_count != 1)
+		return NULL;
+
+	frame = (CSCM_FRAME *)env->frame->value;
+	if (frame->size < size)
+		return NULL;
+
+
+	return env->frame;
+}
+
+
+/*	Make env_obj extend outer instead of its current outer
+ * environment, so that it can be reused by another application. */
+void cscm_env_set_outer(CSCM_OBJECT *env_obj, CSCM_OBJECT *outer)
+{
+	CSCM_ENV *env;
+
+
+	if (env_obj == NULL || outer == NULL)
+		cscm_error_report("cscm_env_set_outer", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	if (env->outer == NULL)
+		cscm_error_report("cscm_env_set_outer", \
+				CSCM_ERROR_ENV_EMPTY);
+	else if (env->outer == outer) // e.g. self tail calls
+		return;
+
+
+	/* outer can be reached only through the current one */
+	cscm_gc_inc(outer);
+	cscm_gc_dec(env->outer);
+	cscm_gc_free(env->outer);
+
+	env->outer = outer;
+	env->n_frames = ((CSCM_ENV *)outer->value)->n_frames + 1;
+}
+
+
+/* index 0 is the innermost frame */
+CSCM_OBJECT *cscm_env_get_frame(CSCM_OBJECT *env_obj, size_t index)
+{
+	CSCM_ENV *env;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_frame", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(env_obj) != CSCM_OBJECT_TYPE_ENV)
+		cscm_error_report("cscm_env_get_frame", \
+				CSCM_ERROR_OBJECT_TYPE);
+	else if (env_obj->value == NULL)
+		cscm_error_report("cscm_env_get_frame", \
+				CSCM_ERROR_EMPTY_OBJECT);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	if (index >= env->n_frames)
+		cscm_error_report("cscm_env_get_frame", \
+				CSCM_ERROR_ENV_BAD_DEPTH);
+
+
+	for (; index > 0; index--)
+		env = (CSCM_ENV *)env->outer->value;
+
+
+	return env->frame;
 }
 
 
@@ -367,7 +856,6 @@ CSCM_OBJECT *cscm_env_cpy_extend(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame)
 
 CSCM_OBJECT *cscm_env_get_var(CSCM_OBJECT *env_obj, char *var)
 {
-	int i;
 	CSCM_ENV *env;
 	CSCM_OBJECT *val;
 
@@ -375,7 +863,7 @@ CSCM_OBJECT *cscm_env_get_var(CSCM_OBJECT *env_obj, char *var)
 	if (env_obj == NULL)
 		cscm_error_report("cscm_env_get_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (env_obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(env_obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_get_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (env_obj->value == NULL)
@@ -389,10 +877,14 @@ CSCM_OBJECT *cscm_env_get_var(CSCM_OBJECT *env_obj, char *var)
 	env = (CSCM_ENV *)env_obj->value;
 
 
-	for (i = 0; i < env->n_frames; i++) {
-		val = cscm_frame_get_var(env->frames[i], var);
+	for (;;) {
+		val = cscm_frame_get_var(env->frame, var);
 		if (val)
 			return val;
+		else if (env->outer == NULL)
+			break;
+
+		env = (CSCM_ENV *)env->outer->value;
 	}
 
 
@@ -404,7 +896,6 @@ CSCM_OBJECT *cscm_env_get_var(CSCM_OBJECT *env_obj, char *var)
 
 void cscm_env_set_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val)
 {
-	int i;
 	CSCM_ENV *env;
 	CSCM_OBJECT *old_val;
 
@@ -412,7 +903,7 @@ void cscm_env_set_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val)
 	if (env_obj == NULL)
 		cscm_error_report("cscm_env_set_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (env_obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(env_obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_set_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (env_obj->value == NULL)
@@ -429,12 +920,16 @@ void cscm_env_set_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val)
 	env = (CSCM_ENV *)env_obj->value;
 
 
-	for (i = 0; i < env->n_frames; i++) {
-		old_val = cscm_frame_get_var(env->frames[i], var);
+	for (;;) {
+		old_val = cscm_frame_get_var(env->frame, var);
 		if (old_val) {
-			cscm_frame_set_var(env->frames[i], var, val);
+			cscm_frame_set_var(env->frame, var, val);
 			return;
+		} else if (env->outer == NULL) {
+			break;
 		}
+
+		env = (CSCM_ENV *)env->outer->value;
 	}
 
 
@@ -452,7 +947,7 @@ void cscm_env_add_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val)
 	if (env_obj == NULL)
 		cscm_error_report("cscm_env_add_var", \
 				CSCM_ERROR_NULL_PTR);
-	else if (env_obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(env_obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_add_var", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (env_obj->value == NULL)
@@ -474,7 +969,242 @@ void cscm_env_add_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val)
 
 
 
-	cscm_frame_add_var(env->frames[0], var, val);
+	cscm_frame_add_var(env->frame, var, val);
+}
+
+
+
+
+/*	Get the value of var by its lexical address. When the binding
+ * has not been created yet(the definition of var is not evaluated),
+ * fall back to searching all frames by the name. */
+CSCM_OBJECT *cscm_env_get_var_at(CSCM_OBJECT *env_obj,	\
+				size_t depth, size_t slot,	\
+				char *var)
+{
+	size_t i;
+
+	CSCM_ENV *env;
+	CSCM_FRAME *frame;
+
+	CSCM_OBJECT *val;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_var_at", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	if (depth >= env->n_frames)
+		cscm_error_report("cscm_env_get_var_at", \
+				CSCM_ERROR_ENV_BAD_DEPTH);
+
+	for (i = depth; i > 0; i--)
+		env = (CSCM_ENV *)env->outer->value;
+
+
+	frame = (CSCM_FRAME *)env->frame->value;
+	if (slot >= frame->n_bindings)
+		return cscm_env_get_var(env_obj, var);
+
+
+	val = frame->vals[slot];
+	if (CSCM_CELL_IS(val))
+		val = CSCM_CELL_GET(val);
+
+	if (val == CSCM_UNASSIGNED)
+		cscm_runtime_error_report(var, CSCM_ERROR_FRAME_UNASSIGNED);
+
+
+	return val;
+}
+
+
+void cscm_env_set_var_at(CSCM_OBJECT *env_obj,		\
+			size_t depth, size_t slot,	\
+			char *var, CSCM_OBJECT *val)
+{
+	size_t i;
+
+	CSCM_ENV *env;
+	CSCM_FRAME *frame;
+
+	CSCM_OBJECT *old_val;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_set_var_at", \
+				CSCM_ERROR_NULL_PTR);
+	else if (val == NULL)
+		cscm_error_report("cscm_env_set_var_at", \
+				CSCM_ERROR_ENV_NO_VAL);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	if (depth >= env->n_frames)
+		cscm_error_report("cscm_env_set_var_at", \
+				CSCM_ERROR_ENV_BAD_DEPTH);
+
+	for (i = depth; i > 0; i--)
+		env = (CSCM_ENV *)env->outer->value;
+
+
+	frame = (CSCM_FRAME *)env->frame->value;
+	if (slot >= frame->n_bindings) {
+		cscm_env_set_var(env_obj, var, val);
+		return;
+	}
+
+
+	old_val = frame->vals[slot];
+	if (CSCM_CELL_IS(old_val))
+		old_val = CSCM_CELL_GET(old_val);
+
+	if (old_val == CSCM_UNASSIGNED)
+		cscm_runtime_error_report(var, CSCM_ERROR_FRAME_UNASSIGNED);
+
+
+	_cscm_frame_store(frame, slot, val);
+}
+
+
+
+
+/* search only the outermost frame, which is the global frame */
+/*	Create the environment of a flat closure: a frame holding the
+ * values of vars found at their lexical addresses in env_obj, which
+ * extends the global environment. Cells are copied rather than looked
+ * through, so that the frames share them. */
+CSCM_OBJECT *cscm_env_capture(CSCM_OBJECT *env_obj, size_t n,	\
+			char **vars,				\
+			size_t *depths, size_t *slots)
+{
+	int i;
+	size_t depth;
+	CSCM_ENV *env;
+	CSCM_FRAME *frame, *new_frame;
+
+	CSCM_OBJECT *new_frame_obj, *val;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_capture", \
+				CSCM_ERROR_NULL_PTR);
+	else if (n == 0)
+		return cscm_global_env_get();
+	else if (vars == NULL || depths == NULL || slots == NULL)
+		cscm_error_report("cscm_env_capture", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	new_frame_obj = cscm_frame_create(n);
+	new_frame = (CSCM_FRAME *)new_frame_obj->value;
+
+	for (i = 0; i < n; i++) {
+		env = (CSCM_ENV *)env_obj->value;
+		if (depths[i] >= env->n_frames)
+			cscm_error_report("cscm_env_capture", \
+					CSCM_ERROR_ENV_BAD_DEPTH);
+
+		for (depth = depths[i]; depth > 0; depth--)
+			env = (CSCM_ENV *)env->outer->value;
+
+
+		frame = (CSCM_FRAME *)env->frame->value;
+		if (slots[i] < frame->n_bindings)
+			val = frame->vals[slots[i]];
+		else
+			val = cscm_env_get_var(env_obj, vars[i]);
+
+		cscm_gc_inc(val);
+		new_frame->vars[i] = vars[i];
+		new_frame->vals[i] = val;
+	}
+
+	new_frame->n_bindings = n;
+
+
+	return cscm_env_extend(cscm_global_env_get(), new_frame_obj);
+}
+
+
+
+
+CSCM_OBJECT *cscm_env_get_global_var(CSCM_OBJECT *env_obj, char *var)
+{
+	CSCM_ENV *env;
+	CSCM_OBJECT *val;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_global_var", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	while (env->outer)
+		env = (CSCM_ENV *)env->outer->value;
+
+	val = cscm_frame_get_var(env->frame, var);
+	if (val == NULL)
+		cscm_runtime_error_report(var, CSCM_ERROR_ENV_UNBOUND);
+
+
+	return val;
+}
+
+
+/*	Global bindings are never removed, so the cell returned is
+ * valid as long as the global environment, and it sees all later
+ * assignments and redefinitions of var. */
+CSCM_OBJECT *cscm_env_get_global_cell(CSCM_OBJECT *env_obj, char *var)
+{
+	CSCM_ENV *env;
+	CSCM_OBJECT *cell;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_get_global_cell", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	while (env->outer)
+		env = (CSCM_ENV *)env->outer->value;
+
+	cell = cscm_frame_get_cell(env->frame, var);
+	if (cell == NULL)
+		cscm_runtime_error_report(var, CSCM_ERROR_ENV_UNBOUND);
+
+
+	return cell;
+}
+
+
+void cscm_env_set_global_var(CSCM_OBJECT *env_obj, \
+			char *var, CSCM_OBJECT *val)
+{
+	CSCM_ENV *env;
+	CSCM_OBJECT *frame;
+
+
+	if (env_obj == NULL)
+		cscm_error_report("cscm_env_set_global_var", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	env = (CSCM_ENV *)env_obj->value;
+	while (env->outer)
+		env = (CSCM_ENV *)env->outer->value;
+
+	frame = env->frame;
+
+	if (cscm_frame_get_var(frame, var) == NULL)
+		cscm_runtime_error_report(var, CSCM_ERROR_ENV_UNBOUND);
+
+
+	cscm_frame_set_var(frame, var, val);
 }
 
 
@@ -492,12 +1222,12 @@ CSCM_OBJECT *_cscm_global_env_create()
 	env = (CSCM_ENV *)obj->value;
 
 
-	env->frames = cscm_object_ptrs_create(1);
+	/*	All top-level definitions are made in this frame, so it
+	 * is searched through an index rather than scanned. */
+	frame = cscm_frame_create(CSCM_FRAME_INIT_SIZE);
+	cscm_frame_index(frame);
 
-
-	frame = cscm_frame_create();
-
-	env->frames[0] = frame;
+	env->frame = frame;
 	cscm_gc_inc(frame);
 
 
@@ -617,6 +1347,7 @@ CSCM_OBJECT *_cscm_global_env = NULL;
 CSCM_OBJECT *cscm_global_env_setup()
 {
 	size_t index;
+	char *name;
 
 	CSCM_OBJECT *env;
 
@@ -638,9 +1369,8 @@ CSCM_OBJECT *cscm_global_env_setup()
 
 	data = _cscm_env_builtin_data;
 	for (; *data; data++, index++) {
-		cscm_env_add_var(env,				\
-				_cscm_env_builtin_names[index],	\
-				*data);
+		name = cscm_symbol_intern_text(_cscm_env_builtin_names[index]);
+		cscm_env_add_var(env, name, *data);
 	}
 
 
@@ -649,9 +1379,8 @@ CSCM_OBJECT *cscm_global_env_setup()
 		proc = cscm_proc_prim_create();
 		cscm_proc_prim_set(proc, *pp_func);
 
-		cscm_env_add_var(env,				\
-				_cscm_env_builtin_names[index],	\
-				proc);
+		name = cscm_symbol_intern_text(_cscm_env_builtin_names[index]);
+		cscm_env_add_var(env, name, proc);
 	}
 
 
@@ -679,7 +1408,7 @@ void cscm_frame_print(CSCM_OBJECT *obj, FILE *stream)
 	if (obj == NULL || stream == NULL)
 		cscm_error_report("cscm_frame_print", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_print", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -693,11 +1422,13 @@ void cscm_frame_print_details(CSCM_OBJECT *obj, char *prefix)
 	int i;
 	CSCM_FRAME *frame;
 
+	CSCM_OBJECT *val;
+
 
 	if (obj == NULL || prefix == NULL)
 		cscm_error_report("cscm_frame_print_details", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_print_details", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -705,7 +1436,12 @@ void cscm_frame_print_details(CSCM_OBJECT *obj, char *prefix)
 	frame = (CSCM_FRAME *)obj->value;
 	for (i = 0; i < frame->n_bindings; i++) {
 		printf("%s%-16s: ", prefix, frame->vars[i]);
-		cscm_object_print(frame->vals[i], stdout);
+
+		val = frame->vals[i];
+		if (val && CSCM_CELL_IS(val)) // cells are not values
+			val = CSCM_CELL_GET(val);
+
+		cscm_object_print(val, stdout);
 		puts("");
 	}
 }
@@ -716,7 +1452,7 @@ void cscm_env_print(CSCM_OBJECT *obj, FILE *stream)
 	if (obj == NULL || stream == NULL)
 		cscm_error_report("cscm_env_print", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_print", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -734,18 +1470,20 @@ void cscm_env_print_details(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_env_print_details", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_print_details", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
 	env = (CSCM_ENV *)obj->value;
-	for (i = 0; i < env->n_frames; i++) {
+	for (i = 0; env; i++) {
 		if (i > 0)
 			puts("");
 
 		printf("FRAME %d:\n", i);
-		cscm_frame_print_details(env->frames[i], "\t");
+		cscm_frame_print_details(env->frame, "\t");
+
+		env = env->outer ? (CSCM_ENV *)env->outer->value : NULL;
 	}
 }
 
@@ -759,7 +1497,7 @@ void cscm_unassigned_print(CSCM_OBJECT *obj, FILE *stream)
 
 	if (obj == CSCM_UNASSIGNED)
 		fputs("**UNASSIGNED**", stdout);
-	else if (obj->type == CSCM_OBJECT_TYPE_UNASSIGNED)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_UNASSIGNED)
 		cscm_error_report("cscm_unassigned_print", \
 				CSCM_ERROR_UNASSIGNED_EXTRA_COPY);
 	else
@@ -780,7 +1518,7 @@ void cscm_frame_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_frame_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_FRAME)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_FRAME)
 		cscm_error_report("cscm_frame_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -789,30 +1527,33 @@ void cscm_frame_free(CSCM_OBJECT *obj)
 
 
 	for (i = 0; i < frame->n_bindings; i++) {
-		free(frame->vars[i]);
-
 		cscm_gc_dec(frame->vals[i]);
 		cscm_gc_free(frame->vals[i]);
 	}
 
 
-	free(frame);
+	if (frame->vars != (char **)(frame + 1))
+		free(frame->vars);
+
+	if (frame->index)
+		free(frame->index);
 
-	free(obj);
+	cscm_object_destroy_inline(obj, sizeof(CSCM_FRAME)		\
+					+ frame->inline_size		\
+					* (sizeof(char *)		\
+					+ sizeof(CSCM_OBJECT *)));
 }
 
 
 void cscm_env_free(CSCM_OBJECT *obj)
 {
-	int i;
-
 	CSCM_ENV *env;
 
 
 	if (obj == NULL)
 		cscm_error_report("cscm_env_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_ENV)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_ENV)
 		cscm_error_report("cscm_env_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -820,17 +1561,16 @@ void cscm_env_free(CSCM_OBJECT *obj)
 	env = (CSCM_ENV *)obj->value;
 
 
-	for (i = 0; i < env->n_frames; i++) {
-		cscm_gc_dec(env->frames[i]);
-		cscm_gc_free(env->frames[i]);
-	}
-
+	cscm_gc_dec(env->frame);
+	cscm_gc_free(env->frame);
 
-	free(env->frames);
+	if (env->outer) {
+		cscm_gc_dec(env->outer);
+		cscm_gc_free(env->outer);
+	}
 
-	free(env);
 
-	free(obj);
+	cscm_object_destroy_inline(obj, sizeof(CSCM_ENV));
 }
 
 
@@ -844,8 +1584,8 @@ void cscm_unassigned_free(CSCM_OBJECT *obj)
 
 
 	if (obj == CSCM_UNASSIGNED)
-		return; // since it is not stored on the heap
-	else if (obj->type == CSCM_OBJECT_TYPE_UNASSIGNED)
+		return; // since it is an immediate object
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_UNASSIGNED)
 		cscm_error_report("cscm_unassigned_free", \
 				CSCM_ERROR_UNASSIGNED_EXTRA_COPY);
 	else
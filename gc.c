@@ -16,6 +16,7 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
 
 #include <stddef.h>
+#include <stdlib.h>
 #include <stdio.h>
 
 #include "error.h"
@@ -23,15 +24,17 @@
 #include "bool.h"
 #include "pair.h"
 #include "env.h"
+#include "proc.h"
+#include "mem.h"
 #include "gc.h"
 
 
 
 
-/*	The 4 objects CSCM_NIL, CSCM_TRUE, CSCM_FALSE, CSCM_UNASSIGNED
- * are stored in heap and not allocated by cscm_object_create(), there-
- * fore are not counted by cscm_gc_inc_total_object_count(). */
-size_t _cscm_gc_total_object_count = 4;
+/*	Immediate objects(fixnums, CSCM_NIL, CSCM_TRUE, CSCM_FALSE and
+ * CSCM_UNASSIGNED) have no storage at all, therefore are not counted
+ * by cscm_gc_inc_total_object_count(). */
+size_t _cscm_gc_total_object_count = 0;
 
 
 void cscm_gc_inc_total_object_count()
@@ -56,11 +59,180 @@ void cscm_gc_dec_total_object_count()
 
 
 
+/*	During a collection, gc_refs of a scanned container starts as
+ * its reference count plus 1, and then references from other scanned
+ * containers are subtracted. Containers left with gc_refs above 1 are
+ * referenced from outside, and they are roots along with floating
+ * containers whose reference counts are 0. Counts too large for the
+ * bits of gc_refs stay at _CSCM_GC_REFS_MAX, as if referenced from
+ * outside.
+ *	Outside collections, gc_refs is 0, or the index plus 1 of a
+ * buffered candidate, or _CSCM_GC_REFS_PENDING. */
+#define _CSCM_GC_REFS_REACHABLE		((1U << CSCM_OBJECT_GC_REFS_BITS) - 1)
+#define _CSCM_GC_REFS_GARBAGE		(_CSCM_GC_REFS_REACHABLE - 1)
+#define _CSCM_GC_REFS_PENDING		(_CSCM_GC_REFS_REACHABLE - 2)
+#define _CSCM_GC_REFS_MAX		(_CSCM_GC_REFS_REACHABLE - 3)
+
+
+#define _CSCM_GC_REFS_IS_COUNT(refs)	\
+		((refs) > 0 && (refs) <= _CSCM_GC_REFS_MAX)
+
+
+
+
+size_t _cscm_gc_threshold = CSCM_GC_DEFAULT_THRESHOLD;
+size_t _cscm_gc_last_n_allocated = 0;
+
+
+int _cscm_gc_flag_collecting = 0;
+
+
+
+
+/* containers are objects which can be a part of a cycle */
+int _cscm_gc_is_container(CSCM_OBJECT *obj)
+{
+	if (obj == NULL || CSCM_OBJECT_IS_IMMEDIATE(obj))
+		return 0;
+
+
+	switch (obj->type) {
+	case CSCM_OBJECT_TYPE_PAIR:
+	case CSCM_OBJECT_TYPE_FRAME:
+	case CSCM_OBJECT_TYPE_ENV:
+	case CSCM_OBJECT_TYPE_PROC_COMP:
+	case CSCM_OBJECT_TYPE_CELL:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+
+
+
+void _cscm_gc_array_push(CSCM_OBJECT ***array_ptr,	\
+			size_t *n_ptr,			\
+			size_t *size_ptr,		\
+			CSCM_OBJECT *obj)
+{
+	if (*n_ptr >= *size_ptr) {
+		*size_ptr = *size_ptr ? 2 * *size_ptr : 1024;
+
+		*array_ptr = realloc(*array_ptr, \
+				*size_ptr * sizeof(CSCM_OBJECT *));
+		if (*array_ptr == NULL)
+			cscm_libc_fail("_cscm_gc_array_push", "realloc");
+	}
+
+
+	(*array_ptr)[(*n_ptr)++] = obj;
+}
+
+
+
+
+/*	A garbage cycle always loses its last outside reference by a
+ * decrement which leaves a non-zero count, so containers decremented
+ * this way are buffered as candidates, and a collection only scans
+ * containers reachable from them. */
+size_t _cscm_gc_n_candidates = 0;
+size_t _cscm_gc_candidates_size = 0;
+CSCM_OBJECT **_cscm_gc_candidates = NULL;
+
+
+void _cscm_gc_buffer(CSCM_OBJECT *obj)
+{
+	if (_cscm_gc_threshold == 0 || _cscm_gc_flag_collecting)
+		return;
+	else if (obj->gc_refs != 0)
+		return; // already buffered, or queued to be freed
+	else if (!_cscm_gc_is_container(obj))
+		return;
+	else if (_cscm_gc_n_candidates >= _CSCM_GC_REFS_MAX)
+		return;
+
+
+	_cscm_gc_array_push(&_cscm_gc_candidates,	\
+			&_cscm_gc_n_candidates,		\
+			&_cscm_gc_candidates_size,	\
+			obj);
+
+	obj->gc_refs = (unsigned int)_cscm_gc_n_candidates;
+}
+
+
+/* called before obj is freed or queued */
+void _cscm_gc_unbuffer(CSCM_OBJECT *obj)
+{
+	if (_cscm_gc_flag_collecting				\
+		|| !_CSCM_GC_REFS_IS_COUNT(obj->gc_refs))
+		return;
+
+
+	_cscm_gc_candidates[obj->gc_refs - 1] = NULL;
+	obj->gc_refs = 0;
+}
+
+
+
+
+/*	An object whose count is decremented to 0 is not freed at once,
+ * because C code may still be using it, like the return value of a
+ * procedure whose frame has just been released. It is queued in the
+ * zero count table instead, which is reconciled by cscm_gc_check().
+ *	Temporaries of the evaluator, like arguments and return values
+ * in flight, are not counted at all. At safe points where cscm_gc_check()
+ * is called, they must be counted by other objects, or stored in
+ * pointers from cscm_object_ptrs_push() or in root slots, which are
+ * all scanned when the table is reconciled. */
+size_t _cscm_gc_free_budget = CSCM_GC_DEFAULT_FREE_BUDGET;
+
+
+/*	Set during collections, so that cscm_gc_free() only queues
+ * objects until all garbage has been found. */
+int _cscm_gc_flag_freeing = 0;
+
+
+size_t _cscm_gc_n_pending = 0;
+size_t _cscm_gc_pending_size = 0;
+CSCM_OBJECT **_cscm_gc_pending = NULL;
+
+
+/*	A few objects in the table can hold a long list, so it is also
+ * reconciled after every _CSCM_GC_RECONCILE_BYTES allocated. */
+#define _CSCM_GC_RECONCILE_BYTES	(64 * 1024)
+
+size_t _cscm_gc_last_reconciled = 0;
+
+
+
+
+void _cscm_gc_defer(CSCM_OBJECT *obj)
+{
+	_cscm_gc_unbuffer(obj);
+
+	obj->gc_refs = _CSCM_GC_REFS_PENDING;
+
+	_cscm_gc_array_push(&_cscm_gc_pending,		\
+			&_cscm_gc_n_pending,		\
+			&_cscm_gc_pending_size,		\
+			obj);
+}
+
+
+
+
 void cscm_gc_inc(CSCM_OBJECT *obj)
 {
 	if (obj == NULL)
 		cscm_error_report("cscm_gc_inc", \
 				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_IS_IMMEDIATE(obj))
+		return; // immediate objects have no reference count
+	else if (obj->ref_count == UINT32_MAX)
+		cscm_error_report("cscm_gc_inc", \
+				CSCM_ERROR_GC_RC_OVERFLOW);
 
 
 	obj->ref_count++;
@@ -72,38 +244,193 @@ void cscm_gc_dec(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_gc_dec", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj == CSCM_NIL	\
-		|| obj == CSCM_TRUE	\
-		|| obj == CSCM_FALSE	\
-		|| obj == CSCM_UNASSIGNED)
-		return; // allow these objects to have zero reference count
+	else if (CSCM_OBJECT_IS_IMMEDIATE(obj))
+		return; // immediate objects have no reference count
 	else if (obj->ref_count == 0)
 		cscm_error_report("cscm_gc_dec", \
 				CSCM_ERROR_GC_ZERO_RC);
 
 
 	obj->ref_count--;
+
+	if (obj->ref_count > 0) {
+		if (obj->gc_refs == 0)
+			_cscm_gc_buffer(obj);
+	} else if (obj->type == CSCM_OBJECT_TYPE_ENV			\
+		|| obj->type == CSCM_OBJECT_TYPE_FRAME) {
+		return; // never values, so freed by cscm_gc_free() at once
+	} else if (!_cscm_gc_flag_collecting				\
+		&& obj->gc_refs != _CSCM_GC_REFS_PENDING) {
+		_cscm_gc_defer(obj);
+	}
+}
+
+
+
+
+size_t _cscm_gc_n_roots = 0;
+size_t _cscm_gc_roots_size = 0;
+CSCM_GC_ROOTS *_cscm_gc_roots = NULL;
+
+
+
+
+/*	slots must stay valid until they are popped, and they can be
+ * NULL or be filled later. */
+void cscm_gc_push_roots(CSCM_OBJECT **slots, size_t n)
+{
+	if (slots == NULL && n > 0)
+		cscm_error_report("cscm_gc_push_roots", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (_cscm_gc_n_roots >= _cscm_gc_roots_size) {
+		_cscm_gc_roots_size = _cscm_gc_roots_size		\
+					? 2 * _cscm_gc_roots_size : 64;
+
+		_cscm_gc_roots = realloc(_cscm_gc_roots,		\
+					_cscm_gc_roots_size		\
+					* sizeof(CSCM_GC_ROOTS));
+		if (_cscm_gc_roots == NULL)
+			cscm_libc_fail("cscm_gc_push_roots", "realloc");
+	}
+
+
+	_cscm_gc_roots[_cscm_gc_n_roots].slots = slots;
+	_cscm_gc_roots[_cscm_gc_n_roots].n = n;
+	_cscm_gc_n_roots++;
+}
+
+
+void cscm_gc_pop_roots()
+{
+	if (_cscm_gc_n_roots == 0)
+		cscm_error_report("cscm_gc_pop_roots", \
+				CSCM_ERROR_GC_NO_ROOTS);
+
+
+	_cscm_gc_n_roots--;
+}
+
+
+
+
+/* f is called with each temporary in root slots and the stack */
+CSCM_GC_VISIT_FUNC _cscm_gc_temps_visit_func;
+
+
+void _cscm_gc_temps_visit_block(void *start, size_t size)
+{
+	int i;
+	CSCM_OBJECT **slots;
+
+
+	slots = (CSCM_OBJECT **)start;
+
+	for (i = 0; i < size / sizeof(CSCM_OBJECT *); i++)
+		if (slots[i] != NULL && !CSCM_OBJECT_IS_IMMEDIATE(slots[i]))
+			_cscm_gc_temps_visit_func(&slots[i]);
+}
+
+
+void _cscm_gc_temps_visit(CSCM_GC_VISIT_FUNC f)
+{
+	int i;
+
+
+	_cscm_gc_temps_visit_func = f;
+
+	for (i = 0; i < _cscm_gc_n_roots; i++)
+		_cscm_gc_temps_visit_block(_cscm_gc_roots[i].slots,	\
+					_cscm_gc_roots[i].n		\
+					* sizeof(CSCM_OBJECT *));
+
+	cscm_mem_stack_walk(_cscm_gc_temps_visit_block);
+}
+
+
+
+
+void cscm_gc_set_free_budget(size_t budget)
+{
+	_cscm_gc_free_budget = budget;
+}
+
+
+void _cscm_gc_free_object(CSCM_OBJECT *obj)
+{
+	cscm_object_free(obj);
+
+	#ifdef __CSCM_GC_DEBUG__
+		cscm_gc_dec_total_object_count();
+	#endif
+}
+
+
+void _cscm_gc_hold(CSCM_OBJECT **slot)
+{
+	(*slot)->ref_count++;
+}
+
+
+/* left to its owner even if it reaches 0 */
+void _cscm_gc_unhold(CSCM_OBJECT **slot)
+{
+	(*slot)->ref_count--;
 }
 
 
+/*	Temporaries hold a reference while the table is reconciled, and
+ * objects they release in turn are queued behind the others, so at
+ * most _cscm_gc_free_budget objects are freed each time. */
+void _cscm_gc_reconcile()
+{
+	size_t i;
+	CSCM_OBJECT *obj;
+
+
+	_cscm_gc_temps_visit(_cscm_gc_hold);
+
+	for (i = 0; _cscm_gc_n_pending > 0				\
+		&& (_cscm_gc_free_budget == 0 || i < _cscm_gc_free_budget); \
+		i++) {
+		obj = _cscm_gc_pending[--_cscm_gc_n_pending];
+		obj->gc_refs = 0;
+
+		if (obj->ref_count == 0)
+			_cscm_gc_free_object(obj);
+		else // it has been referenced again, maybe by a cycle
+			_cscm_gc_buffer(obj);
+	}
+
+	_cscm_gc_temps_visit(_cscm_gc_unhold);
+
+
+	_cscm_gc_last_reconciled = cscm_mem_get_n_allocated();
+}
 
 
+/*	Only floating objects which have never been counted, or whose
+ * counts have been decremented to 0 during a collection, are freed
+ * by cscm_gc_free(), and the others are left to the table. */
 void cscm_gc_free(CSCM_OBJECT *obj)
 {
 	if (obj == NULL)
 		cscm_error_report("cscm_gc_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj == CSCM_NIL	\
-		|| obj == CSCM_TRUE	\
-		|| obj == CSCM_FALSE	\
-		|| obj == CSCM_UNASSIGNED)
-		return; // these objects will not affect the total object count
-	else if (obj->ref_count == 0) {
-		cscm_object_free(obj);
-
-		#ifdef __CSCM_GC_DEBUG__
-			cscm_gc_dec_total_object_count();
-		#endif
+	else if (CSCM_OBJECT_IS_IMMEDIATE(obj))
+		return; // immediate objects are never allocated
+	else if (obj->ref_count != 0)
+		return;
+	else if (obj->gc_refs == _CSCM_GC_REFS_PENDING)
+		return; // it will be freed when the table is reconciled
+
+
+	if (_cscm_gc_flag_freeing) {
+		_cscm_gc_defer(obj);
+	} else {
+		_cscm_gc_unbuffer(obj);
+		_cscm_gc_free_object(obj);
 	}
 }
 
@@ -119,7 +446,308 @@ void cscm_gc_show_total_object_count(char *stage)
 
 	puts("------------------------------------------------------");
 
-	printf("Entering <stage %s>, total object count = %lu\n\n",	\
+	printf("Entering <stage %s>, total object count = %lu\n",	\
 		stage,							\
 		(unsigned long)_cscm_gc_total_object_count);
+
+	cscm_mem_print_occupancy(stdout);
+	puts("");
+}
+
+
+
+
+/* containers reachable from candidates, in the order they are found */
+size_t _cscm_gc_n_objs = 0;
+size_t _cscm_gc_objs_size = 0;
+CSCM_OBJECT **_cscm_gc_objs = NULL;
+
+
+/* containers to be marked, then garbage to be freed */
+size_t _cscm_gc_n_stack = 0;
+size_t _cscm_gc_stack_size = 0;
+CSCM_OBJECT **_cscm_gc_stack = NULL;
+
+
+
+
+void cscm_gc_set_threshold(size_t threshold)
+{
+	_cscm_gc_threshold = threshold;
+}
+
+
+
+
+void _cscm_gc_visit(CSCM_OBJECT *obj, CSCM_GC_VISIT_FUNC f)
+{
+	int i;
+
+	CSCM_PAIR *pair;
+	CSCM_FRAME *frame;
+	CSCM_ENV *env;
+	CSCM_PROC_COMP *proc;
+
+
+	switch (obj->type) {
+	case CSCM_OBJECT_TYPE_PAIR:
+		pair = (CSCM_PAIR *)obj->value;
+		f((CSCM_OBJECT **)&pair->car);
+		f((CSCM_OBJECT **)&pair->cdr);
+		break;
+	case CSCM_OBJECT_TYPE_FRAME:
+		frame = (CSCM_FRAME *)obj->value;
+		for (i = 0; i < frame->n_bindings; i++)
+			f(&frame->vals[i]);
+		break;
+	case CSCM_OBJECT_TYPE_ENV:
+		env = (CSCM_ENV *)obj->value;
+		f(&env->frame);
+		f(&env->outer);
+		break;
+	case CSCM_OBJECT_TYPE_PROC_COMP:
+		proc = (CSCM_PROC_COMP *)obj->value;
+		f(&proc->env);
+		break;
+	case CSCM_OBJECT_TYPE_CELL:
+		f((CSCM_OBJECT **)&obj->value);
+		break;
+	}
+}
+
+
+
+
+/*	Containers in the zero count table can be referenced again, so
+ * they are scanned like others, but never freed as garbage since the
+ * table still holds them. _CSCM_GC_REFS_PENDING is restored after the
+ * collection. */
+void _cscm_gc_collect_scan(CSCM_OBJECT **slot)
+{
+	size_t refs;
+	CSCM_OBJECT *obj;
+
+
+	obj = *slot;
+	if (!_cscm_gc_is_container(obj))
+		return;
+	else if (obj->gc_refs != 0 && obj->gc_refs != _CSCM_GC_REFS_PENDING)
+		return; // already scanned
+
+
+	refs = (size_t)obj->ref_count + 1;
+
+	if (obj->gc_refs == _CSCM_GC_REFS_PENDING)
+		refs++; // the table holds it until it is reconciled
+
+	obj->gc_refs = refs < _CSCM_GC_REFS_MAX				\
+			? (unsigned int)refs : _CSCM_GC_REFS_MAX;
+
+	_cscm_gc_array_push(&_cscm_gc_objs,		\
+			&_cscm_gc_n_objs,		\
+			&_cscm_gc_objs_size,		\
+			obj);
+}
+
+
+/* all containers referenced by scanned ones are scanned */
+void _cscm_gc_collect_subtract(CSCM_OBJECT **slot)
+{
+	CSCM_OBJECT *obj;
+
+
+	obj = *slot;
+	if (_cscm_gc_is_container(obj)				\
+		&& obj->gc_refs > 1					\
+		&& obj->gc_refs < _CSCM_GC_REFS_MAX)
+		obj->gc_refs--;
+}
+
+
+void _cscm_gc_collect_mark(CSCM_OBJECT **slot)
+{
+	CSCM_OBJECT *obj;
+
+
+	obj = *slot;
+	if (!_cscm_gc_is_container(obj))
+		return;
+	else if (!_CSCM_GC_REFS_IS_COUNT(obj->gc_refs))
+		return; // already marked, or not scanned
+
+
+	obj->gc_refs = _CSCM_GC_REFS_REACHABLE;
+
+	_cscm_gc_array_push(&_cscm_gc_stack,		\
+			&_cscm_gc_n_stack,		\
+			&_cscm_gc_stack_size,		\
+			obj);
+}
+
+
+/*	Objects which are not garbage get one reference less, but those
+ * reachable from roots are left to their owners even if their counts
+ * reach 0. Garbage is freed by cscm_gc_collect() itself. */
+void _cscm_gc_collect_clear(CSCM_OBJECT **slot)
+{
+	CSCM_OBJECT *obj;
+
+
+	obj = *slot;
+	if (obj == NULL || CSCM_OBJECT_IS_IMMEDIATE(obj))
+		return;
+
+
+	*slot = CSCM_UNASSIGNED;
+
+	if (obj->gc_refs == _CSCM_GC_REFS_GARBAGE)
+		return;
+
+
+	cscm_gc_dec(obj);
+
+	if (obj->gc_refs != _CSCM_GC_REFS_REACHABLE)
+		cscm_gc_free(obj);
+}
+
+
+
+
+/*	Non-container temporaries are only protected from being freed
+ * when they are referenced by garbage, so they are unmarked after the
+ * garbage has been cleared. */
+void _cscm_gc_collect_mark_temp(CSCM_OBJECT **slot)
+{
+	if (_cscm_gc_is_container(*slot))
+		_cscm_gc_collect_mark(slot);
+	else
+		(*slot)->gc_refs = _CSCM_GC_REFS_REACHABLE;
+}
+
+
+void _cscm_gc_collect_unmark_temp(CSCM_OBJECT **slot)
+{
+	if (!_cscm_gc_is_container(*slot))
+		(*slot)->gc_refs = 0;
+}
+
+
+/*	Trial deletion over containers reachable from candidates: those
+ * whose counts are not explained by references among themselves are
+ * roots, and containers which can not be reached from roots are
+ * garbage cycles. */
+void cscm_gc_collect()
+{
+	int i;
+	CSCM_OBJECT *obj;
+
+
+	/* nothing can be freed until all garbage is found */
+	_cscm_gc_flag_freeing = 1;
+	_cscm_gc_flag_collecting = 1;
+
+
+	for (i = 0; i < _cscm_gc_n_candidates; i++)
+		if (_cscm_gc_candidates[i] != NULL)
+			_cscm_gc_candidates[i]->gc_refs = 0;
+
+	_cscm_gc_n_objs = 0;
+
+	for (i = 0; i < _cscm_gc_n_candidates; i++) {
+		obj = _cscm_gc_candidates[i];
+		if (obj != NULL && obj->ref_count > 0)
+			_cscm_gc_collect_scan(&obj);
+	}
+
+	_cscm_gc_n_candidates = 0;
+
+	for (i = 0; i < _cscm_gc_n_objs; i++) // _cscm_gc_n_objs grows
+		_cscm_gc_visit(_cscm_gc_objs[i], _cscm_gc_collect_scan);
+
+	for (i = 0; i < _cscm_gc_n_objs; i++)
+		_cscm_gc_visit(_cscm_gc_objs[i], _cscm_gc_collect_subtract);
+
+
+	_cscm_gc_n_stack = 0;
+
+	for (i = 0; i < _cscm_gc_n_objs; i++) {
+		obj = _cscm_gc_objs[i];
+		if (obj->ref_count == 0 || obj->gc_refs > 1)
+			_cscm_gc_collect_mark(&obj);
+	}
+
+	_cscm_gc_temps_visit(_cscm_gc_collect_mark_temp);
+
+	while (_cscm_gc_n_stack > 0) {
+		obj = _cscm_gc_stack[--_cscm_gc_n_stack];
+		_cscm_gc_visit(obj, _cscm_gc_collect_mark);
+	}
+
+
+	for (i = 0; i < _cscm_gc_n_objs; i++) {
+		obj = _cscm_gc_objs[i];
+		if (obj->gc_refs != _CSCM_GC_REFS_REACHABLE) {
+			obj->gc_refs = _CSCM_GC_REFS_GARBAGE;
+
+			_cscm_gc_array_push(&_cscm_gc_stack,	\
+					&_cscm_gc_n_stack,	\
+					&_cscm_gc_stack_size,	\
+					obj);
+		}
+	}
+
+	for (i = 0; i < _cscm_gc_n_stack; i++)
+		_cscm_gc_visit(_cscm_gc_stack[i], _cscm_gc_collect_clear);
+
+
+	for (i = 0; i < _cscm_gc_n_objs; i++)
+		if (_cscm_gc_objs[i]->gc_refs == _CSCM_GC_REFS_REACHABLE)
+			_cscm_gc_objs[i]->gc_refs = 0;
+
+	_cscm_gc_temps_visit(_cscm_gc_collect_unmark_temp);
+
+	for (i = 0; i < _cscm_gc_n_pending; i++)
+		_cscm_gc_pending[i]->gc_refs = _CSCM_GC_REFS_PENDING;
+
+
+	#ifdef __CSCM_GC_DEBUG__
+		printf("*** GC DEBUG INFO *** cycle collection: %lu/%lu\n", \
+			(unsigned long)_cscm_gc_n_stack,		\
+			(unsigned long)_cscm_gc_n_objs);
+	#endif
+
+	for (i = 0; i < _cscm_gc_n_stack; i++) {
+		obj = _cscm_gc_stack[i];
+		obj->ref_count = 0;
+
+		_cscm_gc_free_object(obj);
+	}
+
+	_cscm_gc_flag_collecting = 0;
+	_cscm_gc_flag_freeing = 0;
+
+
+	_cscm_gc_last_n_allocated = cscm_mem_get_n_allocated();
+}
+
+
+/*	A safe point where the zero count table is reconciled, and a
+ * collection may start. */
+void cscm_gc_check()
+{
+	if (_cscm_gc_n_pending > 0					\
+		&& (_cscm_gc_n_pending >= _cscm_gc_free_budget		\
+			|| cscm_mem_get_n_allocated()			\
+				- _cscm_gc_last_reconciled		\
+				>= _CSCM_GC_RECONCILE_BYTES))
+		_cscm_gc_reconcile();
+
+
+	if (_cscm_gc_threshold == 0 || _cscm_gc_n_candidates == 0)
+		return;
+
+
+	if (cscm_mem_get_n_allocated() - _cscm_gc_last_n_allocated \
+		>= _cscm_gc_threshold)
+		cscm_gc_collect();
 }
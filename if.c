@@ -112,7 +112,8 @@ CSCM_OBJECT *_cscm_if_ef(void *state, CSCM_OBJECT *env)
 
 			if (ef->type != CSCM_EF_TYPE_COMBINATION	\
 				&& ef->type != CSCM_EF_TYPE_IF		\
-				&& ef->type != CSCM_EF_TYPE_SEQ)
+				&& ef->type != CSCM_EF_TYPE_SEQ		\
+				&& ef->type != CSCM_EF_TYPE_LET)
 				cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
 			ret = cscm_ef_exec(ef, env);
@@ -124,7 +125,8 @@ CSCM_OBJECT *_cscm_if_ef(void *state, CSCM_OBJECT *env)
 
 		if (ef->type != CSCM_EF_TYPE_COMBINATION	\
 			&& ef->type != CSCM_EF_TYPE_IF		\
-			&& ef->type != CSCM_EF_TYPE_SEQ)
+			&& ef->type != CSCM_EF_TYPE_SEQ		\
+			&& ef->type != CSCM_EF_TYPE_LET)
 			cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
 
 		ret = cscm_ef_exec(ef, env);
@@ -22,6 +22,8 @@
 
 
 
+#include <stddef.h>
+
 #include "ef.h"
 #include "ast.h"
 
@@ -31,6 +33,11 @@
 struct _CSCM_ASSIGNMENT_EF_STATE {
 	char *var;
 	CSCM_EF *val_ef;
+
+	/* lexical address */
+	int addr;
+	size_t depth;
+	size_t slot;
 };
 
 
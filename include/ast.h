@@ -36,7 +36,10 @@
 
 #define CSCM_AST_TEXT_MAX_LEN		256
 
-#define CSCM_AST_EXP_PAGE_MAX_N		16
+/*	The array of pages has room for CSCM_AST_EXP_PAGE_INIT_N
+ * pages at first, and it is doubled whenever it is full, so there is
+ * no limit on the number of child nodes, e.g. top-level expressions. */
+#define CSCM_AST_EXP_PAGE_INIT_N	16
 #define CSCM_AST_EXP_PAGE_SIZE		128
 
 
@@ -131,7 +134,6 @@ void cscm_ast_print_tree(CSCM_AST_NODE *node);
 
 #define CSCM_ERROR_AST_EMPTY_SYMBOL		"empty CSCM_AST_NODE(symbol)"
 #define CSCM_ERROR_AST_EMPTY_EXP		"empty CSCM_AST_NODE(exp)"
-#define CSCM_ERROR_AST_FULL_EXP			"CSCM_AST_NODE(exp) is full"
 
 
 #define CSCM_ERROR_AST_EOF			"unexpected EOF"
@@ -27,11 +27,9 @@
 
 
 
-extern CSCM_OBJECT _cscm_bool_true;
-extern CSCM_OBJECT _cscm_bool_false;
-
-#define CSCM_TRUE	(&_cscm_bool_true)
-#define CSCM_FALSE	(&_cscm_bool_false)
+/* true and false are immediate objects, see object.h */
+#define CSCM_TRUE	CSCM_OBJECT_SPECIAL_MAKE(CSCM_OBJECT_TYPE_BOOL_TRUE)
+#define CSCM_FALSE	CSCM_OBJECT_SPECIAL_MAKE(CSCM_OBJECT_TYPE_BOOL_FALSE)
 
 
 
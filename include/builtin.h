@@ -24,6 +24,9 @@
 
 #include <stddef.h>
 
+#include "object.h"
+#include "proc.h"
+
 
 
 
@@ -186,4 +189,30 @@ CSCM_OBJECT *cscm_builtin_proc_error(size_t n, CSCM_OBJECT **args);
 
 
 
+/*	Arithmetic and comparison primitives which combinations of
+ * two arguments apply without cscm_apply(), as long as the operator
+ * still evaluates to the primitive, see cscm_builtin_inline_apply(). */
+#define CSCM_BUILTIN_INLINE_ADD		0
+#define CSCM_BUILTIN_INLINE_SUBTRACT	1
+#define CSCM_BUILTIN_INLINE_MULTIPLY	2
+#define CSCM_BUILTIN_INLINE_EQUAL_NUM	3
+#define CSCM_BUILTIN_INLINE_GREATER	4
+#define CSCM_BUILTIN_INLINE_GREATER_EQ	5
+#define CSCM_BUILTIN_INLINE_LESS	6
+#define CSCM_BUILTIN_INLINE_LESS_EQ	7
+#define CSCM_BUILTIN_INLINE_NONE	8
+
+
+
+
+int cscm_builtin_inline_find(char *name);
+CSCM_PROC_PRIM_FUNC cscm_builtin_inline_get_f(int op);
+
+
+CSCM_OBJECT *cscm_builtin_inline_apply(int op, \
+			CSCM_OBJECT *x, CSCM_OBJECT *y);
+
+
+
+
 #endif
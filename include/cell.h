@@ -0,0 +1,63 @@
+/* cell.h -- shared cells of captured variables
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#ifndef __CSCM_CELL_H__
+
+#define __CSCM_CELL_H__
+
+
+
+
+#include <stdio.h>
+
+#include "object.h"
+
+
+
+
+/*	A variable captured by closures is kept in a cell when it can
+ * still change after being captured, so that its frame and all the
+ * closures share it. Cells are stored in frames in place of the values,
+ * and never seen by scheme programs, since frames look through them.
+ * The value is stored in obj->value directly. */
+#define CSCM_CELL_IS(obj)	\
+	(CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_CELL)
+
+#define CSCM_CELL_GET(obj)	((CSCM_OBJECT *)(obj)->value)
+
+
+
+
+CSCM_OBJECT *cscm_cell_create(CSCM_OBJECT *val);
+
+
+void cscm_cell_set(CSCM_OBJECT *cell, CSCM_OBJECT *val);
+
+
+
+
+void cscm_cell_print(CSCM_OBJECT *obj, FILE *stream);
+
+
+
+
+void cscm_cell_free(CSCM_OBJECT *obj);
+
+
+
+
+#endif
@@ -48,11 +48,21 @@ typedef struct _CSCM_SA_FUNCS CSCM_SA_FUNCS;
 
 
 
+/*	proc_ef is NULL when the operator is a procedure bound by
+ * letrec which is never used as a value. Such a procedure has no
+ * object at run time, so the combination applies the lambda expression
+ * in *lambda_ef_ptr directly, within the environment which is depth
+ * frames out of the current one. */
 struct _CSCM_COMBINATION_EF_STATE {
 	CSCM_EF *proc_ef;
 
+	CSCM_EF **lambda_ef_ptr;
+	size_t depth;
+
 	size_t n_arg_efs;
 	CSCM_EF **arg_efs;
+
+	int op; // CSCM_BUILTIN_INLINE_*
 };
 
 
@@ -61,6 +71,15 @@ typedef struct _CSCM_COMBINATION_EF_STATE CSCM_COMBINATION_EF_STATE;
 
 
 
+/*	Combinations of at most CSCM_COMBINATION_MAX_FIXED_ARGS
+ * arguments keep their operator and operands in an array on the C
+ * stack, which is registered as roots of garbage collections, rather
+ * than in the stack of temporaries. */
+#define CSCM_COMBINATION_MAX_FIXED_ARGS	4
+
+
+
+
 #define CSCM_ERROR_ANALYZE_UNKNOWN_EXP_TYPE	"unknown expression type"
 
 
@@ -78,6 +97,16 @@ CSCM_EF *cscm_analyze(CSCM_AST_NODE *exp);
 
 
 
+CSCM_OBJECT *cscm_apply_env(CSCM_OBJECT *tail_env,			\
+			CSCM_OBJECT *outer,				\
+			int flag_dtn,					\
+			int flag_stacked,				\
+			size_t n_params, char **params,			\
+			size_t frame_size,				\
+			size_t n_args, CSCM_OBJECT **args);
+CSCM_OBJECT *cscm_apply_body(CSCM_EF *body_ef, CSCM_OBJECT *env);
+
+
 CSCM_OBJECT *cscm_apply(CSCM_OBJECT *proc, \
 		size_t n_args, CSCM_OBJECT **args);
 int cscm_is_combination(CSCM_AST_NODE *exp);
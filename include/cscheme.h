@@ -25,9 +25,14 @@
 // #define __CSCM_CSCHEME_DEBUG__
 
 
+// #define __CSCM_CSCHEME_MALLOC__
+
+
 
 
 #define CSCM_ERROR_CSCHEME_ARGC			"incorrect number of arguments"
+#define CSCM_ERROR_CSCHEME_GC_OPTION		"bad value of garbage collection option"
+#define CSCM_ERROR_CSCHEME_ENGINE_OPTION	"bad value of engine option"
 
 
 #define CSCM_ERROR_CSCHEME_TEST_AST_MOD_EOL	"end of line has been detected"
@@ -55,6 +55,9 @@ typedef struct _CSCM_DEFINITION_EF_STATE CSCM_DEFINITION_EF_STATE;
 #define CSCM_ERROR_DEFINITION_EMPTY_BODY	\
 	"empty body in definition expression"
 
+#define CSCM_ERROR_DEFINITION_DUP_PARAMS	\
+	"duplicate formal parameters in definition expression"
+
 
 
 
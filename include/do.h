@@ -0,0 +1,50 @@
+/* do.h -- scheme do expression(syntactic sugar)
+
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#ifndef __CSCM_DO_H__
+
+#define __CSCM_DO_H__
+
+
+
+
+#include "ef.h"
+#include "ast.h"
+
+
+
+
+#define CSCM_ERROR_DO_NO_BINDING	"no binding in do expression"
+#define CSCM_ERROR_DO_BAD_BINDINGS	"bad bindings in do expression"
+#define CSCM_ERROR_DO_BAD_BINDING	"bad binding in do expression"
+#define CSCM_ERROR_DO_DUP_VARS		"duplicate variables in do expression"
+
+
+#define CSCM_ERROR_DO_NO_TEST		"no test clause in do expression"
+#define CSCM_ERROR_DO_BAD_TEST		"bad test clause in do expression"
+
+
+
+
+int cscm_is_do(CSCM_AST_NODE *exp);
+CSCM_EF *cscm_analyze_do(CSCM_AST_NODE *exp);
+
+
+
+
+#endif
@@ -52,7 +52,10 @@
 #define CSCM_EF_TYPE_SEQ		11
 #define CSCM_EF_TYPE_AO			12
 #define CSCM_EF_TYPE_COMBINATION	13
-#define CSCM_EF_TYPE_NONE		14
+#define CSCM_EF_TYPE_LET		14
+#define CSCM_EF_TYPE_BODY		15
+#define CSCM_EF_TYPE_VM			16
+#define CSCM_EF_TYPE_NONE		17
 
 
 
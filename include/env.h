@@ -29,24 +29,56 @@
 
 
 
-#define CSCM_FRAME_MAX_SIZE	512
+/*	Frames are allocated with the capacity their creators ask
+ * for, and they will grow geometrically when that capacity is
+ * used up. This is the capacity of the first growth of an empty
+ * frame. */
+#define CSCM_FRAME_INIT_SIZE	8
 
 
+/* initial number of entries of the index of a frame */
+#define CSCM_FRAME_INDEX_INIT_SIZE	1024
+
+
+
+
+/*	An open-addressing hash table with linear probing, which maps
+ * the addresses of variables to their positions in a frame. Entries
+ * hold positions plus one, so that 0 marks empty entries. Bindings
+ * stay in vars and vals in the order they are made. */
+struct _CSCM_FRAME_INDEX {
+	size_t size; // a power of 2
+	size_t *entries;
+};
+
+typedef struct _CSCM_FRAME_INDEX CSCM_FRAME_INDEX;
 
 
 struct _CSCM_FRAME {
 	size_t n_bindings;
-
-	char *vars[CSCM_FRAME_MAX_SIZE];
-	CSCM_OBJECT *vals[CSCM_FRAME_MAX_SIZE];
+	size_t size; // capacity of vars and vals
+	size_t inline_size; // capacity stored inline when created
+
+	/*	Variables are interned by cscm_symbol_intern_text, and
+	 * they are shared rather than copied, and compared by their
+	 * addresses. All names passed to frames and environments
+	 * must be interned. */
+	char **vars;
+	CSCM_OBJECT **vals;
+
+	/*	NULL unless the frame is searched through an index, see
+	 * cscm_frame_index(). */
+	CSCM_FRAME_INDEX *index;
 };
 
 typedef struct _CSCM_FRAME CSCM_FRAME;
 
 
 struct _CSCM_ENV {
-	size_t n_frames;
-	CSCM_OBJECT **frames;
+	size_t n_frames; // including the frames of outer environments
+
+	CSCM_OBJECT *frame; // the innermost frame
+	CSCM_OBJECT *outer; // NULL for the global environment
 };
 
 typedef struct _CSCM_ENV CSCM_ENV;
@@ -54,11 +86,7 @@ typedef struct _CSCM_ENV CSCM_ENV;
 
 
 
-#define CSCM_ERROR_FRAME_TOO_MANY_VARS	"too many variables"
-
-
 #define CSCM_ERROR_FRAME_NOT_EMPTY	"frame is not empty"
-#define CSCM_ERROR_FRAME_FULL		"frame is full"
 
 
 #define CSCM_ERROR_FRAME_NO_VAR		"variable name is not specified"
@@ -69,9 +97,6 @@ typedef struct _CSCM_ENV CSCM_ENV;
 #define CSCM_ERROR_FRAME_UNBOUND	"unbound variable"
 
 
-#define CSCM_ERROR_FRAME_NOT_UNIQUE	"specified variables have duplications"
-
-
 #define CSCM_ERROR_FRAME_EMPTY_BINDING	"empty binding"
 
 
@@ -87,6 +112,9 @@ typedef struct _CSCM_ENV CSCM_ENV;
 #define CSCM_ERROR_ENV_EMPTY		"empty environment"
 
 
+#define CSCM_ERROR_ENV_BAD_DEPTH	"lexical address is out of environment"
+
+
 
 
 #define CSCM_ERROR_UNASSIGNED_EXTRA_COPY \
@@ -104,14 +132,14 @@ typedef struct _CSCM_ENV CSCM_ENV;
 
 
 
-extern CSCM_OBJECT _cscm_unassigned;
-
-#define CSCM_UNASSIGNED	(&_cscm_unassigned)
+/* **UNASSIGNED** is an immediate object, see object.h */
+#define CSCM_UNASSIGNED	CSCM_OBJECT_SPECIAL_MAKE(CSCM_OBJECT_TYPE_UNASSIGNED)
 
 
 
 
-CSCM_OBJECT *cscm_frame_create();
+CSCM_OBJECT *cscm_frame_create(size_t size);
+CSCM_OBJECT *cscm_frame_create_stacked(size_t size);
 
 
 void cscm_frame_init(CSCM_OBJECT *frame_obj, size_t n, char **vars, CSCM_OBJECT **vals);
@@ -122,12 +150,32 @@ CSCM_OBJECT *cscm_frame_get_var(CSCM_OBJECT *frame_obj, char *var);
 void cscm_frame_set_var(CSCM_OBJECT *frame_obj, char *var, CSCM_OBJECT *val);
 
 
+void cscm_frame_reinit(CSCM_OBJECT *frame_obj, \
+		size_t n, char **vars, CSCM_OBJECT **vals);
+
+
+void cscm_frame_make_cells(CSCM_OBJECT *frame_obj,	\
+			size_t n, size_t *slots,	\
+			char **vars);
+CSCM_OBJECT *cscm_frame_get_cell(CSCM_OBJECT *frame_obj, char *var);
+
+
+void cscm_frame_index(CSCM_OBJECT *frame_obj);
+
+
 
 
 CSCM_OBJECT *cscm_env_create();
 
 
-CSCM_OBJECT *cscm_env_cpy_extend(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame);
+CSCM_OBJECT *cscm_env_extend(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame);
+CSCM_OBJECT *cscm_env_extend_stacked(CSCM_OBJECT *env_obj, CSCM_OBJECT *frame);
+
+
+CSCM_OBJECT *cscm_env_get_outer(CSCM_OBJECT *env_obj, size_t depth);
+CSCM_OBJECT *cscm_env_get_frame(CSCM_OBJECT *env_obj, size_t index);
+CSCM_OBJECT *cscm_env_get_private_frame(CSCM_OBJECT *env_obj, size_t size);
+void cscm_env_set_outer(CSCM_OBJECT *env_obj, CSCM_OBJECT *outer);
 
 
 CSCM_OBJECT *cscm_env_get_var(CSCM_OBJECT *env_obj, char *var);
@@ -135,6 +183,25 @@ void cscm_env_set_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val);
 void cscm_env_add_var(CSCM_OBJECT *env_obj, char *var, CSCM_OBJECT *val);
 
 
+CSCM_OBJECT *cscm_env_get_var_at(CSCM_OBJECT *env_obj,	\
+				size_t depth, size_t slot,	\
+				char *var);
+void cscm_env_set_var_at(CSCM_OBJECT *env_obj,		\
+			size_t depth, size_t slot,	\
+			char *var, CSCM_OBJECT *val);
+
+
+CSCM_OBJECT *cscm_env_capture(CSCM_OBJECT *env_obj, size_t n,	\
+			char **vars,				\
+			size_t *depths, size_t *slots);
+
+
+CSCM_OBJECT *cscm_env_get_global_var(CSCM_OBJECT *env_obj, char *var);
+CSCM_OBJECT *cscm_env_get_global_cell(CSCM_OBJECT *env_obj, char *var);
+void cscm_env_set_global_var(CSCM_OBJECT *env_obj, \
+			char *var, CSCM_OBJECT *val);
+
+
 
 
 CSCM_OBJECT *cscm_global_env_setup();
@@ -22,6 +22,9 @@
 
 
 
+#include <stddef.h>
+
+#include "object.h"
 #include "cscheme.h"
 
 
@@ -44,9 +47,26 @@ void cscm_gc_inc(CSCM_OBJECT *obj);
 void cscm_gc_dec(CSCM_OBJECT *obj);
 
 
+/*	Objects whose counts are decremented to 0 are queued in a zero
+ * count table instead of being freed recursively, and the table is
+ * reconciled by cscm_gc_check() once CSCM_GC_DEFAULT_FREE_BUDGET
+ * objects are queued. At most as many objects are freed each time, so
+ * that dropping a long list will not stall the interpreter. The rest
+ * are left for later calls. */
+#define CSCM_GC_DEFAULT_FREE_BUDGET	4096
+
+
+#define CSCM_GC_FREE_BUDGET_OPTION	"--gc-free-budget="
+
+
+
+
 void cscm_gc_free(CSCM_OBJECT *obj);
 
 
+void cscm_gc_set_free_budget(size_t budget);
+
+
 
 
 void cscm_gc_show_total_object_count(char *stage);
@@ -54,7 +74,60 @@ void cscm_gc_show_total_object_count(char *stage);
 
 
 
+/*	Reference counting can not reclaim cycles, like a compound
+ * procedure defined in a frame of the environment it captures. Pairs,
+ * frames, environments and compound procedures whose counts are
+ * decremented to non-zero values are buffered as candidates, and a
+ * collection starting after every CSCM_GC_DEFAULT_THRESHOLD bytes have
+ * been allocated reclaims cycles reachable from them by trial deletion.
+ *	Objects referenced by C code are found by their reference counts,
+ * because counts contributed by other objects are subtracted during a
+ * collection. However, a value held by a C variable without being
+ * counted must be stored in pointers from cscm_object_ptrs_push(), or
+ * be pushed by cscm_gc_push_roots(), as long as any compound procedure
+ * might be applied before it is released. */
+#define CSCM_GC_DEFAULT_THRESHOLD	(8 * 1024 * 1024)
+
+
+#define CSCM_GC_THRESHOLD_OPTION	"--gc-threshold="
+
+
+
+
+struct _CSCM_GC_ROOTS {
+	CSCM_OBJECT **slots;
+	size_t n;
+};
+
+
+typedef struct _CSCM_GC_ROOTS CSCM_GC_ROOTS;
+
+
+
+
+typedef void (*CSCM_GC_VISIT_FUNC)(CSCM_OBJECT **slot);
+
+
+
+
+void cscm_gc_set_threshold(size_t threshold);
+
+
+void cscm_gc_push_roots(CSCM_OBJECT **slots, size_t n);
+void cscm_gc_pop_roots();
+
+
+void cscm_gc_check();
+void cscm_gc_collect();
+
+
+
+
 #define CSCM_ERROR_GC_ZERO_RC		"reference count equals zero"
+#define CSCM_ERROR_GC_RC_OVERFLOW	"reference count overflows"
+
+
+#define CSCM_ERROR_GC_NO_ROOTS		"no roots have been pushed"
 
 
 
@@ -26,6 +26,7 @@
 
 #include "ef.h"
 #include "ast.h"
+#include "scope.h"
 
 
 
@@ -42,6 +43,9 @@
 #define CSCM_ERROR_LAMBDA_BAD_DTN	\
 	"bad dotted-tail notation in lambda expression"
 
+#define CSCM_ERROR_LAMBDA_DUP_PARAMS	\
+	"duplicate formal parameters in lambda expression"
+
 
 
 
@@ -53,11 +57,26 @@
 
 struct _CSCM_LAMBDA_EF_STATE {
 	int flag_dtn; // dotted-tail notation
+	int flag_stacked; // applications can place frames on the frame stack
 
 	size_t n_params;
-	char **params;
+	char **params; // interned
+
+	/*	the number of formal parameters plus the number of
+	 * internal definitions in the body */
+	size_t frame_size;
 
 	CSCM_EF *body;
+
+	/*	Variables copied from the environment when a flat
+	 * closure is created, see cscm_env_capture(). flag_flat is not
+	 * set when the procedure keeps the whole environment. */
+	int flag_flat;
+
+	size_t n_captures;
+	char **captures; // interned
+	size_t *depths;
+	size_t *slots;
 };
 
 
@@ -66,11 +85,27 @@ typedef struct _CSCM_LAMBDA_EF_STATE CSCM_LAMBDA_EF_STATE;
 
 
 
+/*	The body of a procedure whose frames keep some variables in
+ * cells, which are created before the body is executed. */
+struct _CSCM_LAMBDA_BODY_EF_STATE {
+	CSCM_SCOPE_CELLS *cells;
+
+	CSCM_EF *body;
+};
+
+
+typedef struct _CSCM_LAMBDA_BODY_EF_STATE CSCM_LAMBDA_BODY_EF_STATE;
+
+
+
+
 int cscm_is_lambda(CSCM_AST_NODE *exp);
 CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp);
+CSCM_EF *cscm_analyze_lambda_known(CSCM_AST_NODE *exp);
 
 
 void cscm_lambda_ef_free(CSCM_EF *ef);
+void cscm_lambda_body_ef_free(CSCM_EF *ef);
 
 
 
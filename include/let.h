@@ -1,6 +1,6 @@
-/* let.h -- scheme let expression(syntactic sugar)
+/* let.h -- scheme let, named let and letrec expressions
 
-   Copyright (C) 2021 Tongjie Liu <tongjieandliu@gmail.com>.
+   Copyright (C) 2021-2022 Tongjie Liu <tongjieandliu@gmail.com>.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -24,6 +24,33 @@
 
 #include "ef.h"
 #include "ast.h"
+#include "scope.h"
+
+
+
+
+/*	init_efs[i] is NULL when vars[i] is bound to a lambda expression
+ * which is only applied, in which case proc_efs[i] holds the analyzed
+ * lambda expression and no procedure is ever created for it. When it
+ * has turned out to be used as a value as well, init_efs[i] is the
+ * same as proc_efs[i]. proc_efs is only used by letrec expressions. */
+struct _CSCM_LET_EF_STATE {
+	int flag_rec;
+
+	size_t n_vars;
+	char **vars;
+
+	CSCM_EF **init_efs;
+	CSCM_EF **proc_efs;
+
+	size_t frame_size;
+	CSCM_SCOPE_CELLS *cells; // NULL when no variable needs a cell
+
+	CSCM_EF *body;
+};
+
+
+typedef struct _CSCM_LET_EF_STATE CSCM_LET_EF_STATE;
 
 
 
@@ -31,6 +58,9 @@
 #define CSCM_ERROR_LET_NO_BINDING	"no binding in let expression"
 #define CSCM_ERROR_LET_BAD_BINDINGS	"bad bindings in let expression"
 #define CSCM_ERROR_LET_BAD_BINDING	"bad binding in let expression"
+#define CSCM_ERROR_LET_BAD_NAME		"bad name of named let expression"
+#define CSCM_ERROR_LET_DUP_VARS		"duplicate variables in let expression"
+#define CSCM_ERROR_LETREC_DUP_VARS	"duplicate variables in letrec expression"
 
 
 #define CSCM_ERROR_LET_EMPTY_BODY	"empty body in let expression"
@@ -42,6 +72,13 @@ int cscm_is_let(CSCM_AST_NODE *exp);
 CSCM_EF *cscm_analyze_let(CSCM_AST_NODE *exp);
 
 
+int cscm_is_letrec(CSCM_AST_NODE *exp);
+CSCM_EF *cscm_analyze_letrec(CSCM_AST_NODE *exp);
+
+
+void cscm_let_ef_free(CSCM_EF *ef);
+
+
 
 
 #endif
@@ -31,6 +31,8 @@
 
 
 struct _CSCM_AO_EF_STATE { // AO stands for AND/OR
+	int flag_or;
+
 	size_t n_clause_efs;
 	CSCM_EF **clause_efs;
 };
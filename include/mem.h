@@ -0,0 +1,158 @@
+/* mem.h -- memory allocator for runtime objects
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#ifndef __CSCM_MEM_H__
+
+#define __CSCM_MEM_H__
+
+
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cscheme.h"
+
+
+
+
+/*	Route all allocations to malloc and free, so that tools like
+ * ASan and valgrind can track every object. */
+#ifdef __CSCM_CSCHEME_MALLOC__
+	#define __CSCM_MEM_MALLOC__
+#endif
+
+
+
+
+/*	Blocks are grouped into size classes of CSCM_MEM_GRANULE bytes,
+ * and blocks of the same class are carved out of slabs which are
+ * aligned to CSCM_MEM_SLAB_SIZE, so the slab of a block can be found
+ * by masking its address. Blocks larger than the largest class are
+ * allocated by malloc directly. */
+#define CSCM_MEM_GRANULE		16
+#define CSCM_MEM_N_CLASSES		16
+#define CSCM_MEM_MAX_SIZE		(CSCM_MEM_GRANULE * CSCM_MEM_N_CLASSES)
+
+#define CSCM_MEM_SLAB_SIZE		65536
+
+
+
+
+struct _CSCM_MEM_SLAB {
+	size_t class;
+
+	size_t n_used;
+	size_t n_blocks;
+
+	void *free_list;	// freed blocks linked through themselves
+	char *bump;		// blocks never allocated start here
+	char *end;
+
+	/* slabs with free blocks of the same class */
+	struct _CSCM_MEM_SLAB *prev;
+	struct _CSCM_MEM_SLAB *next;
+};
+
+
+typedef struct _CSCM_MEM_SLAB CSCM_MEM_SLAB;
+
+
+
+
+struct _CSCM_MEM_CLASS {
+	size_t n_slabs;
+	size_t n_used;
+
+	CSCM_MEM_SLAB *partial;	// slabs with free blocks
+	CSCM_MEM_SLAB *empty;	// one empty slab kept for reuse
+};
+
+
+typedef struct _CSCM_MEM_CLASS CSCM_MEM_CLASS;
+
+
+
+
+/*	Temporary arrays like arguments of combinations live for no
+ * longer than the C function creating them, so they are allocated
+ * from a stack by increasing its top, and freed in reverse order by
+ * restoring it. Chunks are never moved, and blocks are packed without
+ * padding, so that the whole stack can be walked for pointers. */
+#define CSCM_MEM_STACK_CHUNK_SIZE	65536
+
+
+struct _CSCM_MEM_STACK_CHUNK {
+	struct _CSCM_MEM_STACK_CHUNK *prev;
+
+	char *top;
+	char *end;
+};
+
+
+typedef struct _CSCM_MEM_STACK_CHUNK CSCM_MEM_STACK_CHUNK;
+
+
+
+
+/*	Frames and environments of applications which can not be
+ * captured are allocated from another stack, which is a contiguous
+ * region with a bump pointer. Unlike the stack of temporaries, it is
+ * never walked, and blocks may be popped out of order. */
+#define CSCM_MEM_FRAME_STACK_SIZE	262144
+
+
+
+
+typedef void (*CSCM_MEM_STACK_WALK_FUNC)(void *start, size_t size);
+
+
+
+
+void *cscm_mem_alloc(size_t size);
+void cscm_mem_free(void *ptr, size_t size);
+
+
+void *cscm_mem_stack_push(size_t size);
+void cscm_mem_stack_pop(void *ptr);
+void cscm_mem_stack_walk(CSCM_MEM_STACK_WALK_FUNC f);
+
+
+void *cscm_mem_frame_push(size_t size);
+int cscm_mem_frame_pop(void *ptr, size_t size);
+int cscm_mem_frame_has(void *ptr);
+
+
+size_t cscm_mem_get_n_allocated();
+
+
+
+
+void cscm_mem_print_occupancy(FILE *stream);
+
+
+
+
+#define CSCM_ERROR_MEM_ZERO_SIZE	"requesting zero byte"
+#define CSCM_ERROR_MEM_BAD_SLAB		"block does not belong to its slab"
+#define CSCM_ERROR_MEM_STACK_ORDER	"block is not on the top of the stack"
+
+
+
+
+#endif
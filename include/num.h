@@ -34,11 +34,10 @@
 
 
 
-CSCM_OBJECT *cscm_num_long_create();
+CSCM_OBJECT *cscm_num_long_create(long val);
 CSCM_OBJECT *cscm_num_double_create();
 
 
-void cscm_num_long_set(CSCM_OBJECT *num, long val);
 void cscm_num_double_set(CSCM_OBJECT *num, double val);
 
 
@@ -23,6 +23,7 @@
 
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 
@@ -41,16 +42,23 @@
 #define CSCM_OBJECT_TYPE_BOOL_TRUE	10
 #define CSCM_OBJECT_TYPE_BOOL_FALSE	11
 #define CSCM_OBJECT_TYPE_UNASSIGNED	12
-#define CSCM_OBJECT_TYPE_NONE		13
+#define CSCM_OBJECT_TYPE_CELL		13
+#define CSCM_OBJECT_TYPE_NONE		14
 
 
 
 
+/*	The header is packed into 16 bytes, so that payloads stored
+ * behind it stay aligned, and a pair takes 32 bytes in all. */
+#define CSCM_OBJECT_GC_REFS_BITS	24
+
+
 struct _CSCM_OBJECT {
-	int type;
-	void *value;
+	unsigned int type : 8;
+	unsigned int gc_refs : CSCM_OBJECT_GC_REFS_BITS; // cycle collector
+	uint32_t ref_count;	// gc
 
-	size_t ref_count;	// gc
+	void *value;
 };
 
 
@@ -59,6 +67,58 @@ typedef struct _CSCM_OBJECT CSCM_OBJECT;
 
 
 
+/*	Objects allocated on the heap are aligned to at least 4 bytes,
+ * so the low 2 bits of an object pointer are free to tag immediate
+ * objects which have no heap storage and no reference count:
+ *
+ *	xx...xx1	fixnum, a long shifted left by 1 bit
+ *	xx...x10	special object, its type shifted left by 2 bits
+ *	xx...x00	pointer to a CSCM_OBJECT on the heap
+ *
+ * Longs out of the fixnum range are still allocated on the heap. */
+#define CSCM_OBJECT_TAG_MASK		3
+#define CSCM_OBJECT_TAG_FIXNUM		1
+#define CSCM_OBJECT_TAG_SPECIAL		2
+
+
+#define CSCM_OBJECT_IS_IMMEDIATE(obj)	\
+	(((uintptr_t)(obj) & CSCM_OBJECT_TAG_MASK) != 0)
+
+#define CSCM_OBJECT_IS_FIXNUM(obj)	\
+	(((uintptr_t)(obj) & CSCM_OBJECT_TAG_FIXNUM) != 0)
+
+#define CSCM_OBJECT_IS_SPECIAL(obj)	\
+	(((uintptr_t)(obj) & CSCM_OBJECT_TAG_MASK) == CSCM_OBJECT_TAG_SPECIAL)
+
+
+#define CSCM_FIXNUM_MAX		(INTPTR_MAX >> 1)
+#define CSCM_FIXNUM_MIN		(INTPTR_MIN >> 1)
+
+#define CSCM_FIXNUM_FITS(l)	\
+	((l) >= CSCM_FIXNUM_MIN && (l) <= CSCM_FIXNUM_MAX)
+
+#define CSCM_FIXNUM_MAKE(l)	\
+	((CSCM_OBJECT *)(((uintptr_t)(l) << 1) | CSCM_OBJECT_TAG_FIXNUM))
+
+#define CSCM_FIXNUM_GET(obj)	((long)((intptr_t)(obj) >> 1))
+
+
+#define CSCM_OBJECT_SPECIAL_MAKE(type)	\
+	((CSCM_OBJECT *)(((uintptr_t)(type) << 2) | CSCM_OBJECT_TAG_SPECIAL))
+
+
+/*	All accesses to the type of an object which might be immediate
+ * must be done through this macro. */
+#define CSCM_OBJECT_GET_TYPE(obj)				\
+	(CSCM_OBJECT_IS_FIXNUM(obj)				\
+		? CSCM_OBJECT_TYPE_NUM_LONG			\
+		: CSCM_OBJECT_IS_SPECIAL(obj)			\
+			? (int)((uintptr_t)(obj) >> 2)		\
+			: (obj)->type)
+
+
+
+
 typedef void (*CSCM_OBJECT_PRINT_FUNC)(CSCM_OBJECT *obj, FILE *stream);
 
 
@@ -70,11 +130,21 @@ typedef void (*CSCM_OBJECT_FREE_FUNC)(CSCM_OBJECT *obj);
 
 
 CSCM_OBJECT *cscm_object_create();
+CSCM_OBJECT *cscm_object_create_inline(size_t size);
+CSCM_OBJECT *cscm_object_create_inline_stacked(size_t size);
+
+
+void cscm_object_destroy(CSCM_OBJECT *obj);
+void cscm_object_destroy_inline(CSCM_OBJECT *obj, size_t size);
 
 
 CSCM_OBJECT **cscm_object_ptrs_create(size_t n);
 
 
+CSCM_OBJECT **cscm_object_ptrs_push(size_t n);
+void cscm_object_ptrs_pop(CSCM_OBJECT **ptrs);
+
+
 
 
 void cscm_object_print(CSCM_OBJECT *obj, FILE *stream);
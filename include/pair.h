@@ -84,9 +84,8 @@ void cscm_pair_free(CSCM_OBJECT *obj);
 
 
 
-extern CSCM_OBJECT _cscm_nil;
-
-#define CSCM_NIL	(&_cscm_nil)
+/* nil is an immediate object, see object.h */
+#define CSCM_NIL	CSCM_OBJECT_SPECIAL_MAKE(CSCM_OBJECT_TYPE_NIL)
 
 
 
@@ -45,10 +45,13 @@ typedef struct _CSCM_PROC_PRIM CSCM_PROC_PRIM;
 
 struct _CSCM_PROC_COMP {
 	int flag_dtn; // dotted-tail notation
+	int flag_stacked; // frames of applications can not be captured
 
 	size_t n_params;
 	char **params; // formal parameters
 
+	size_t frame_size; // initial size of the frames of applications
+
 	CSCM_EF *body;
 
 	CSCM_OBJECT *env;
@@ -92,14 +95,18 @@ CSCM_OBJECT *cscm_proc_comp_create();
 
 void cscm_proc_comp_set(CSCM_OBJECT *proc_obj,	\
 		int flag_dtn,			\
+		int flag_stacked,		\
 		size_t n_params, char **params,	\
+		size_t frame_size,		\
 		CSCM_EF *body,			\
 		CSCM_OBJECT *env);
 
 
 size_t cscm_proc_comp_get_flag_dtn(CSCM_OBJECT *proc_obj);
+int cscm_proc_comp_get_flag_stacked(CSCM_OBJECT *proc_obj);
 size_t cscm_proc_comp_get_n_params(CSCM_OBJECT *proc_obj);
 char **cscm_proc_comp_get_params(CSCM_OBJECT *proc_obj);
+size_t cscm_proc_comp_get_frame_size(CSCM_OBJECT *proc_obj);
 CSCM_EF *cscm_proc_comp_get_body(CSCM_OBJECT *proc_obj);
 CSCM_OBJECT *cscm_proc_comp_get_env(CSCM_OBJECT *proc_obj);
 
@@ -24,6 +24,7 @@
 
 #include <stddef.h>
 
+#include "object.h"
 #include "ef.h"
 #include "ast.h"
 
@@ -33,6 +34,8 @@
 struct _CSCM_QUASIQUOTE_EF_STATE {
 	size_t n_efs;
 	CSCM_EF **efs;
+
+	CSCM_OBJECT *tail;	// constant elements behind the last unquote
 };
 
 
@@ -24,23 +24,13 @@
 
 #include <stddef.h>
 
+#include "object.h"
 #include "ef.h"
 #include "ast.h"
 
 
 
 
-struct _CSCM_QUOTE_EF_STATE {
-	size_t n_efs;
-	CSCM_EF **efs;
-};
-
-
-typedef struct _CSCM_QUOTE_EF_STATE CSCM_QUOTE_EF_STATE;
-
-
-
-
 #define CSCM_ERROR_QUOTE_N_CLAUSES	"quote expression only accept 1 clause"
 
 
@@ -49,6 +39,10 @@ typedef struct _CSCM_QUOTE_EF_STATE CSCM_QUOTE_EF_STATE;
 int cscm_is_quote(CSCM_AST_NODE *exp);
 
 
+CSCM_OBJECT *cscm_quote_datum(CSCM_AST_NODE *node);
+
+
+CSCM_EF *cscm_analyze_quote_datum(CSCM_AST_NODE *datum);
 CSCM_EF *cscm_analyze_quote(CSCM_AST_NODE *exp);
 
 
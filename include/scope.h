@@ -0,0 +1,173 @@
+/* scope.h -- compile-time scope
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#ifndef __CSCM_SCOPE_H__
+
+#define __CSCM_SCOPE_H__
+
+
+
+
+#include <stddef.h>
+
+#include "ast.h"
+#include "ef.h"
+
+
+
+
+/*	A scope describes the frame which will be created by applying
+ * a compound procedure: formal parameters come first, and then the
+ * variables of the definitions in the body follow in the order of
+ * their appearance. When a definition can not be found before the
+ * body is analyzed(e.g. a definition inside an if expression), the
+ * layout of the frame can not be known at analysis time and the
+ * scope will be marked dynamic. */
+struct _CSCM_SCOPE_PROC {
+	char *var; // interned
+	CSCM_EF **lambda_ef_ptr; // NULL when var is used as a value
+};
+
+
+typedef struct _CSCM_SCOPE_PROC CSCM_SCOPE_PROC;
+
+
+/*	A lambda expression applied through procedure objects is
+ * analyzed into a flat closure: its body sees a closure scope instead
+ * of the scopes around it, which holds the variables captured so far.
+ * Free variables of the body are added to it when they are resolved,
+ * and their values are copied into a new frame when the procedure is
+ * created, so that the procedure keeps none of the frames around it.
+ * A captured variable which can still change after it is captured is
+ * put into a cell by its own frame, see cell.h. */
+struct _CSCM_SCOPE {
+	int flag_dynamic;
+
+	size_t n_vars;
+	size_t size;
+	char **vars; // interned
+	int *flags; // CSCM_SCOPE_VAR_* of vars
+
+	/* vars before n_params are bound when the frame is created */
+	size_t n_params;
+
+	size_t n_defs;
+	size_t defs_size;
+	CSCM_AST_NODE **defs; // definitions in the body
+
+	/*	Variables bound to lambda expressions by letrec, which can
+	 * be applied without procedure objects as long as they are only
+	 * used as operators of combinations. */
+	size_t n_procs;
+	size_t procs_size;
+	CSCM_SCOPE_PROC *procs;
+
+	/*	Only used by closure scopes, where vars[i] is captured from
+	 * the lexical address (depths[i], slots[i]) of the scopes
+	 * enclosing the lambda expression. The outer scope of a closure
+	 * scope is always NULL. */
+	int flag_closure;
+	size_t *depths;
+	size_t *slots;
+	struct _CSCM_SCOPE *enclosing;
+
+	struct _CSCM_SCOPE *outer;
+};
+
+
+typedef struct _CSCM_SCOPE CSCM_SCOPE;
+
+
+
+
+/*	Variables of a frame which are put into cells when the frame
+ * is created, see cscm_frame_make_cells(). */
+struct _CSCM_SCOPE_CELLS {
+	size_t n_cells;
+	size_t *slots; // in ascending order
+	char **vars; // variables of all slots up to the last cell
+};
+
+
+typedef struct _CSCM_SCOPE_CELLS CSCM_SCOPE_CELLS;
+
+
+
+
+#define CSCM_SCOPE_VAR_CAPTURED		1
+#define CSCM_SCOPE_VAR_ASSIGNED		2
+
+
+
+
+#define CSCM_SCOPE_ADDR_LOCAL		0 // (depth, slot)
+#define CSCM_SCOPE_ADDR_GLOBAL		1 // the outermost frame
+#define CSCM_SCOPE_ADDR_DYNAMIC		2 // search all frames
+
+
+
+
+#define CSCM_ERROR_SCOPE_EMPTY		"no scope has been entered"
+#define CSCM_ERROR_SCOPE_NO_CLOSURE	"no closure scope has been entered"
+
+
+
+
+void cscm_scope_enter(size_t n_params, char **params);
+void cscm_scope_leave();
+
+
+size_t cscm_scope_get_n_vars();
+int cscm_scope_is_dynamic();
+void cscm_scope_set_dynamic();
+
+
+void cscm_scope_add_definition(CSCM_AST_NODE *exp);
+void cscm_scope_check_definition(CSCM_AST_NODE *exp);
+void cscm_scope_scan_body(CSCM_AST_NODE *exp, size_t first);
+void cscm_scope_scan_exp(CSCM_AST_NODE *exp);
+
+
+int cscm_scope_resolve(char *var, size_t *depth_ptr, size_t *slot_ptr);
+int cscm_scope_resolve_assignment(char *var, \
+		size_t *depth_ptr, size_t *slot_ptr);
+void cscm_scope_add_assignment(char *var);
+
+
+void cscm_scope_add_proc(char *var, CSCM_EF **lambda_ef_ptr);
+CSCM_EF **cscm_scope_get_proc(char *var);
+CSCM_EF **cscm_scope_resolve_proc(char *var, size_t *depth_ptr);
+
+
+
+void cscm_scope_add_closure();
+size_t cscm_scope_get_n_closures();
+void cscm_scope_set_n_closures(size_t n);
+
+
+int cscm_scope_enter_closure(CSCM_AST_NODE *exp);
+size_t cscm_scope_leave_closure(char ***vars_ptr, \
+		size_t **depths_ptr, size_t **slots_ptr);
+
+
+CSCM_SCOPE_CELLS *cscm_scope_get_cells();
+void cscm_scope_cells_free(CSCM_SCOPE_CELLS *cells);
+
+
+
+
+#endif
@@ -22,6 +22,8 @@
 
 
 
+#include <stddef.h>
+
 #include "object.h"
 #include "ef.h"
 #include "ast.h"
@@ -29,11 +31,25 @@
 
 
 
-CSCM_OBJECT *cscm_symbol_create();
+#define CSCM_SYMBOL_TABLE_INIT_SIZE	1024
+
+
+
+
+struct _CSCM_SYMBOL_TABLE_ENTRY {
+	size_t hash;
+	CSCM_OBJECT *symbol;
+};
+
+
+typedef struct _CSCM_SYMBOL_TABLE_ENTRY CSCM_SYMBOL_TABLE_ENTRY;
+
+
 
 
-void cscm_symbol_set(CSCM_OBJECT *symbol, char *text);
-void cscm_symbol_set_simple(CSCM_OBJECT *symbol, char *text);
+CSCM_OBJECT *cscm_symbol_intern(char *text);
+CSCM_OBJECT *cscm_symbol_intern_simple(char *text);
+char *cscm_symbol_intern_text(char *text);
 
 
 char *cscm_symbol_get(CSCM_OBJECT *symbol);
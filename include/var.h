@@ -22,18 +22,44 @@
 
 
 
+#include <stddef.h>
+
+#include "object.h"
 #include "ast.h"
 #include "ef.h"
 
 
 
 
+struct _CSCM_VAR_EF_STATE {
+	char *var;
+
+	/* lexical address */
+	int addr;
+	size_t depth;
+	size_t slot;
+
+	/*	The cell of a global variable, which is looked up the
+	 * first time the variable is evaluated, see
+	 * cscm_env_get_global_cell(). */
+	CSCM_OBJECT *cell;
+};
+
+
+typedef struct _CSCM_VAR_EF_STATE CSCM_VAR_EF_STATE;
+
+
+
+
 int cscm_is_var(CSCM_AST_NODE *exp);
 
 
 CSCM_EF *cscm_analyze_var(CSCM_AST_NODE *exp);
 
 
+CSCM_OBJECT *cscm_var_get_global(CSCM_VAR_EF_STATE *state, CSCM_OBJECT *env);
+
+
 void cscm_var_ef_free(CSCM_EF *ef);
 
 
@@ -0,0 +1,188 @@
+/* vm.h -- bytecode compiler and virtual machine
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#ifndef __CSCM_VM_H__
+
+#define __CSCM_VM_H__
+
+
+
+
+#include <stddef.h>
+
+#include "object.h"
+#include "ef.h"
+
+
+
+
+/*	The alternative execution engine compiles analyzed expressions
+ * into instructions of a stack machine, which share lexical addresses,
+ * constants and closures with execution functions. The bodies of lambda
+ * expressions are compiled in place, so that procedures created by
+ * either engine can be applied by the other. */
+#define CSCM_VM_ENGINE_OPTION		"--engine="
+
+
+#define CSCM_VM_ENGINE_EF		"ef"
+#define CSCM_VM_ENGINE_VM		"vm"
+
+
+
+
+#define CSCM_VM_OP_CONST		0
+#define CSCM_VM_OP_LOCAL		1
+#define CSCM_VM_OP_GLOBAL		2
+#define CSCM_VM_OP_DYNAMIC		3
+#define CSCM_VM_OP_SET_LOCAL		4
+#define CSCM_VM_OP_SET_GLOBAL		5
+#define CSCM_VM_OP_SET_DYNAMIC		6
+#define CSCM_VM_OP_DEFINE		7
+#define CSCM_VM_OP_LAMBDA		8
+#define CSCM_VM_OP_POP			9
+#define CSCM_VM_OP_JUMP			10
+#define CSCM_VM_OP_JUMP_IF_FALSE	11
+#define CSCM_VM_OP_AND			12 // jump if false, or pop
+#define CSCM_VM_OP_OR			13 // jump if true, or pop
+#define CSCM_VM_OP_CALL			14
+#define CSCM_VM_OP_TAIL_CALL		15
+#define CSCM_VM_OP_CALL_KNOWN		16
+#define CSCM_VM_OP_TAIL_CALL_KNOWN	17
+#define CSCM_VM_OP_LET			18
+#define CSCM_VM_OP_TAIL_LET		19
+#define CSCM_VM_OP_LETREC		20
+#define CSCM_VM_OP_TAIL_LETREC		21
+#define CSCM_VM_OP_INIT			22
+#define CSCM_VM_OP_MAKE_CELLS		23
+#define CSCM_VM_OP_EF			24
+#define CSCM_VM_OP_INLINE		25 // b is CSCM_BUILTIN_INLINE_*
+#define CSCM_VM_OP_TAIL_INLINE		26
+#define CSCM_VM_OP_RETURN		27
+#define CSCM_VM_OP_NONE			28
+
+
+
+
+struct _CSCM_VM_CODE;
+
+
+/*	handler is the address of the code executing op in the loop
+ * of cscm_vm_run(), and target is the instruction a jump goes to.
+ * Both are filled in once the code is complete. */
+struct _CSCM_VM_INST {
+	void *handler;
+	int op;
+
+	size_t a;
+	size_t b;
+	void *ptr;
+
+	struct _CSCM_VM_INST *target;
+	struct _CSCM_VM_CODE *code; // body of let and letrec expressions
+};
+
+
+typedef struct _CSCM_VM_INST CSCM_VM_INST;
+
+
+struct _CSCM_VM_CODE {
+	size_t n_insts;
+	size_t size;
+	CSCM_VM_INST *insts;
+
+	/*	depth is the number of values on the operand stack at
+	 * the end of the code while it is compiled, and max_depth is
+	 * the number of slots each activation needs. */
+	size_t depth;
+	size_t max_depth;
+
+	size_t n_codes;
+	struct _CSCM_VM_CODE **codes; // codes of nested let expressions
+};
+
+
+typedef struct _CSCM_VM_CODE CSCM_VM_CODE;
+
+
+
+
+/*	The state of a compiled body, which keeps the body it was
+ * compiled from, since the code refers to its states. */
+struct _CSCM_VM_EF_STATE {
+	CSCM_VM_CODE *code;
+
+	CSCM_EF *ef;
+};
+
+
+typedef struct _CSCM_VM_EF_STATE CSCM_VM_EF_STATE;
+
+
+
+
+/*	An activation of compiled code. Control records are kept in
+ * an array rather than on the C stack, so that calls between compiled
+ * procedures never nest cscm_vm_run(). */
+struct _CSCM_VM_FRAME {
+	CSCM_VM_INST *pc;
+
+	CSCM_OBJECT **base; // operand stack of the activation
+	CSCM_OBJECT **sp;
+
+	CSCM_OBJECT *env;
+	int flag_owned; // env is counted by the activation
+};
+
+
+typedef struct _CSCM_VM_FRAME CSCM_VM_FRAME;
+
+
+
+
+#define CSCM_VM_CODE_INIT_SIZE		16
+#define CSCM_VM_FRAMES_INIT_SIZE	64
+
+
+
+
+extern int cscm_vm_mode;
+
+
+
+
+CSCM_VM_CODE *cscm_vm_code_create();
+void cscm_vm_code_free(CSCM_VM_CODE *code);
+
+
+CSCM_VM_CODE *cscm_vm_compile(CSCM_EF *ef);
+void cscm_vm_compile_lambda(CSCM_EF *ef);
+
+
+void **cscm_vm_get_handlers();
+CSCM_OBJECT *cscm_vm_run(CSCM_VM_CODE *code, CSCM_OBJECT *env);
+
+
+CSCM_OBJECT *cscm_vm_exec(CSCM_EF *ef, CSCM_OBJECT *env);
+
+
+CSCM_EF *cscm_vm_ef_construct(CSCM_VM_CODE *code, CSCM_EF *ef);
+void cscm_vm_ef_free(CSCM_EF *ef);
+
+
+
+
+#endif
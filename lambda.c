@@ -23,10 +23,14 @@
 #include "ef.h"
 #include "begin.h"
 #include "text.h"
+#include "symbol.h"
 #include "proc.h"
 #include "num.h"
 #include "str.h"
 #include "var.h"
+#include "definition.h"
+#include "scope.h"
+#include "env.h"
 #include "lambda.h"
 
 
@@ -34,11 +38,11 @@
 
 int cscm_is_lambda(CSCM_AST_NODE *exp)
 {
-	int i;
+	int i, j;
 
 	CSCM_AST_NODE *head;
 
-	CSCM_AST_NODE *param, *params;
+	CSCM_AST_NODE *param, *params, *other;
 
 
 	if (exp == NULL)
@@ -100,6 +104,21 @@ int cscm_is_lambda(CSCM_AST_NODE *exp)
 						param->line,		\
 						CSCM_ERROR_LAMBDA_BAD_DTN);
 			}
+
+			/*	Frames compare names by their addresses
+			 * and do not check duplications themselves. */
+			for (j = 0; j < i; j++) {
+				other = cscm_ast_exp_index(params, j);
+
+				if (cscm_ast_symbol_text_equal(param, "."))
+					break;
+				else if (cscm_ast_symbol_text_equal(param, \
+								other->text))
+					cscm_syntax_error_report(	\
+						param->filename,	\
+						param->line,		\
+						CSCM_ERROR_LAMBDA_DUP_PARAMS);
+			}
 		}
 	} else {
 		cscm_syntax_error_report(params->filename,		\
@@ -129,12 +148,22 @@ CSCM_LAMBDA_EF_STATE *_cscm_lambda_ef_state_create()
 
 
 	state->flag_dtn = 0;
+	state->flag_stacked = 0;
 
 	state->n_params = 0;
 	state->params = NULL;
 
+	state->frame_size = 0;
+
 	state->body = NULL;
 
+	state->flag_flat = 0;
+
+	state->n_captures = 0;
+	state->captures = NULL;
+	state->depths = NULL;
+	state->slots = NULL;
+
 
 	return state;
 }
@@ -150,11 +179,21 @@ CSCM_OBJECT *_cscm_lambda_ef(void *state, CSCM_OBJECT *env)
 	proc = cscm_proc_comp_create();
 
 	s = (CSCM_LAMBDA_EF_STATE *)state;
-	cscm_proc_comp_set(proc,	\
-			s->flag_dtn,	\
-			s->n_params,	\
-			s->params,	\
-			s->body,	\
+
+	if (s->flag_flat)
+		env = cscm_env_capture(env,		\
+				s->n_captures,		\
+				s->captures,		\
+				s->depths,		\
+				s->slots);
+
+	cscm_proc_comp_set(proc,		\
+			s->flag_dtn,		\
+			s->flag_stacked,	\
+			s->n_params,		\
+			s->params,		\
+			s->frame_size,		\
+			s->body,		\
 			env);
 
 
@@ -162,9 +201,60 @@ CSCM_OBJECT *_cscm_lambda_ef(void *state, CSCM_OBJECT *env)
 }
 
 
-CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
+
+
+CSCM_OBJECT *_cscm_lambda_body_ef(void *state, CSCM_OBJECT *env)
+{
+	CSCM_LAMBDA_BODY_EF_STATE *s;
+
+
+	s = (CSCM_LAMBDA_BODY_EF_STATE *)state;
+
+	cscm_frame_make_cells(cscm_env_get_frame(env, 0),	\
+				s->cells->n_cells,		\
+				s->cells->slots,		\
+				s->cells->vars);
+
+
+	return cscm_ef_exec(s->body, env);
+}
+
+
+/*	The execution function is not pushed into the backtrace,
+ * since it has no expression of its own. */
+CSCM_EF *_cscm_lambda_body_ef_construct(CSCM_SCOPE_CELLS *cells, \
+					CSCM_EF *body)
+{
+	CSCM_LAMBDA_BODY_EF_STATE *state;
+
+
+	state = malloc(sizeof(CSCM_LAMBDA_BODY_EF_STATE));
+	if (state == NULL)
+		cscm_libc_fail("_cscm_lambda_body_ef_construct", "malloc");
+
+
+	state->cells = cells;
+	state->body = body;
+
+
+	return cscm_ef_construct(CSCM_EF_TYPE_BODY,	\
+				state,			\
+				NULL,			\
+				_cscm_lambda_body_ef);
+}
+
+
+
+
+/*	Unless the procedure is known, i.e. only applied directly by
+ * combinations without procedure objects, the lambda expression is
+ * analyzed into a flat closure, which falls back to keeping the whole
+ * environment when a dynamic scope has been found in or around it. */
+CSCM_EF *_cscm_analyze_lambda(CSCM_AST_NODE *exp, int flag_known)
 {
 	int i;
+	size_t n_closures;
+	CSCM_SCOPE_CELLS *cells;
 	CSCM_AST_NODE *param, *params;
 	CSCM_AST_NODE *body;
 
@@ -182,9 +272,9 @@ CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
 
 		state->params = malloc(sizeof(char *));
 		if (state->params == NULL)
-			cscm_libc_fail("cscm_analyze_lambda", "malloc");
+			cscm_libc_fail("_cscm_analyze_lambda", "malloc");
 
-		state->params[0] = cscm_text_cpy(params->text);
+		state->params[0] = cscm_symbol_intern_text(params->text);
 	} else {
 		state->n_params = params->n_childs; 
 		state->flag_dtn = 0;
@@ -194,7 +284,7 @@ CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
 		} else {
 			state->params = malloc(params->n_childs * sizeof(char *));
 			if (state->params == NULL)
-				cscm_libc_fail("cscm_analyze_lambda", "malloc");
+				cscm_libc_fail("_cscm_analyze_lambda", "malloc");
 
 			for (i = 0; i < params->n_childs; i++) {
 				param = cscm_ast_exp_index(params, i);
@@ -205,13 +295,13 @@ CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
 					param = cscm_ast_exp_index(params, \
 								i + 1);
 					state->params[i] = \
-						cscm_text_cpy(param->text);
+						cscm_symbol_intern_text(param->text);
 
 					state->n_params--; 
 					break;
 				} else {
 					state->params[i] = \
-						cscm_text_cpy(param->text);
+						cscm_symbol_intern_text(param->text);
 				}
 			}
 		}
@@ -223,8 +313,48 @@ CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
 	for (i = 2; i < exp->n_childs; i++)
 		cscm_ast_exp_append(body, cscm_ast_exp_index(exp, i));
 
+
+	n_closures = cscm_scope_get_n_closures();
+
+	if (!flag_known)
+		state->flag_flat = cscm_scope_enter_closure(exp);
+
+	/*	Variables in the body are resolved to lexical addresses
+	 * against the scope of this lambda expression. */
+	cscm_scope_enter(state->n_params, state->params);
+
+	for (i = 0; i < body->n_childs; i++)
+		if (cscm_is_definition(cscm_ast_exp_index(body, i)))
+			cscm_scope_add_definition(cscm_ast_exp_index(body, i));
+
+	cscm_scope_scan_body(exp, 2);
+
+	/*	Frames created by applications will hold the formal
+	 * parameters and the variables of internal definitions, so
+	 * they can be allocated with the right size at once. */
+	state->frame_size = cscm_scope_get_n_vars();
+
 	state->body = cscm_analyze_seq(body);
 
+	/*	Without creating any procedure object which keeps the
+	 * environment, the body can not keep the environments of
+	 * applications after it returns. */
+	state->flag_stacked = cscm_scope_get_n_closures() == n_closures;
+
+	cells = cscm_scope_get_cells();
+	if (cells)
+		state->body = _cscm_lambda_body_ef_construct(cells, \
+							state->body);
+
+	cscm_scope_leave();
+
+	if (state->flag_flat)
+		state->n_captures = cscm_scope_leave_closure(&state->captures, \
+							&state->depths,	 \
+							&state->slots);
+	else
+		cscm_scope_add_closure();
+
 	cscm_ast_free_exp(body);
 
 
@@ -237,9 +367,24 @@ CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
 
 
 
+CSCM_EF *cscm_analyze_lambda(CSCM_AST_NODE *exp)
+{
+	return _cscm_analyze_lambda(exp, 0);
+}
+
+
+/*	Analyze exp bound by letrec, whose procedure is only applied
+ * directly in the environment of the letrec expression. */
+CSCM_EF *cscm_analyze_lambda_known(CSCM_AST_NODE *exp)
+{
+	return _cscm_analyze_lambda(exp, 1);
+}
+
+
+
+
 void cscm_lambda_ef_free(CSCM_EF *ef)
 {
-	int i;
 	CSCM_LAMBDA_EF_STATE *state;
 
 
@@ -253,14 +398,42 @@ void cscm_lambda_ef_free(CSCM_EF *ef)
 
 	state = (CSCM_LAMBDA_EF_STATE *)ef->state;
 
-	for (i = 0; i < state->n_params; i++)
-		free(state->params[i]);
-
-	if (state->params)
+	if (state->params) // the formal parameters are interned
 		free(state->params);
 
 	cscm_ef_free_tree(state->body);
 
+	if (state->captures) { // the variables are interned
+		free(state->captures);
+		free(state->depths);
+		free(state->slots);
+	}
+
+
+	free(state);
+
+	free(ef);
+}
+
+
+void cscm_lambda_body_ef_free(CSCM_EF *ef)
+{
+	CSCM_LAMBDA_BODY_EF_STATE *state;
+
+
+	if (ef == NULL)
+		cscm_error_report("cscm_lambda_body_ef_free", \
+				CSCM_ERROR_NULL_PTR);
+	else if (ef->type != CSCM_EF_TYPE_BODY)
+		cscm_error_report("cscm_lambda_body_ef_free", \
+				CSCM_ERROR_EF_TYPE);
+
+
+	state = (CSCM_LAMBDA_BODY_EF_STATE *)ef->state;
+
+	cscm_scope_cells_free(state->cells);
+	cscm_ef_free_tree(state->body);
+
 
 	free(state);
 
@@ -1,4 +1,4 @@
-/* let.c -- scheme let expression(syntactic sugar)
+/* let.c -- scheme let, named let and letrec expressions
 
    Copyright (C) 2021-2022 Tongjie Liu <tongjieandliu@gmail.com>.
 
@@ -16,33 +16,43 @@
    along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
 
 #include <stddef.h>
+#include <stdlib.h>
 
 #include "error.h"
 #include "ast.h"
+#include "object.h"
 #include "ef.h"
 #include "core.h"
 #include "symbol.h"
 #include "num.h"
 #include "str.h"
 #include "var.h"
+#include "begin.h"
+#include "definition.h"
+#include "lambda.h"
+#include "scope.h"
+#include "env.h"
+#include "gc.h"
+#include "tco.h"
 #include "let.h"
 
 
 
 
-int cscm_is_let(CSCM_AST_NODE *exp)
+/*	(let ((var init) ...) body ...)
+ *	(let name ((var init) ...) body ...)
+ *	(letrec ((var init) ...) body ...)
+ * The named form is only supported by let. */
+int _cscm_let_check(CSCM_AST_NODE *exp, char *keyword)
 {
-	int i;
+	int i, j, first;
 
-	CSCM_AST_NODE *head;
+	CSCM_AST_NODE *head, *name;
 
-	CSCM_AST_NODE *var, *binding, *bindings;
+	CSCM_AST_NODE *var, *other, *binding, *bindings;
 
 
-	if (exp == NULL)
-		cscm_error_report("cscm_is_let", \
-				CSCM_ERROR_NULL_PTR);
-	else if (!cscm_ast_is_exp(exp))
+	if (!cscm_ast_is_exp(exp))
 		return 0;
 	else if (cscm_ast_is_exp_empty(exp))
 		return 0;
@@ -51,7 +61,7 @@ int cscm_is_let(CSCM_AST_NODE *exp)
 	head = cscm_ast_exp_index(exp, 0);
 	if (!cscm_ast_is_symbol(head))
 		return 0;
-	else if (!cscm_ast_symbol_text_equal(head, "let"))
+	else if (!cscm_ast_symbol_text_equal(head, keyword))
 		return 0;
 
 
@@ -60,17 +70,32 @@ int cscm_is_let(CSCM_AST_NODE *exp)
 				exp->line,		\
 				CSCM_ERROR_LET_NO_BINDING);
 
-	bindings = cscm_ast_exp_index(exp, 1);
+	first = 1;
+
+	name = cscm_ast_exp_index(exp, 1);
+	if (cscm_ast_is_symbol(name)			\
+		&& cscm_ast_symbol_text_equal(head, "let")) {
+		if (cscm_is_num_long(name)		\
+			|| cscm_is_num_double(name)	\
+			|| cscm_is_string(name))
+			cscm_syntax_error_report(name->filename,	\
+					name->line,			\
+					CSCM_ERROR_LET_BAD_NAME);
+		else if (exp->n_childs == 2)
+			cscm_syntax_error_report(exp->filename,	\
+					exp->line,		\
+					CSCM_ERROR_LET_NO_BINDING);
+
+		first = 2;
+	}
+
+	bindings = cscm_ast_exp_index(exp, first);
 	if (!cscm_ast_is_exp(bindings))
 		cscm_syntax_error_report(bindings->filename,	\
 				bindings->line,			\
 				CSCM_ERROR_LET_BAD_BINDINGS);
-	else if (cscm_ast_is_exp_empty(bindings)) // do not support no binding
-		cscm_syntax_error_report(bindings->filename,	\
-				bindings->line,			\
-				CSCM_ERROR_LET_NO_BINDING);
 
-	if (exp->n_childs == 2) // do not support empty body
+	if (exp->n_childs == first + 1) // do not support empty body
 		cscm_syntax_error_report(exp->filename,	\
 				exp->line,			\
 				CSCM_ERROR_LET_EMPTY_BODY);
@@ -99,6 +124,24 @@ int cscm_is_let(CSCM_AST_NODE *exp)
 			cscm_syntax_error_report(var->filename,		\
 					var->line,			\
 					CSCM_ERROR_LET_BAD_BINDING);
+
+		/*	Frames compare names by their addresses
+		 * and do not check duplications themselves. */
+		for (j = 0; j < i; j++) {
+			other = cscm_ast_exp_index(			\
+					cscm_ast_exp_index(bindings, j), 0);
+
+			if (!cscm_ast_symbol_text_equal(var, other->text))
+				continue;
+			else if (cscm_ast_symbol_text_equal(head, "letrec"))
+				cscm_syntax_error_report(var->filename,	\
+						var->line,		\
+						CSCM_ERROR_LETREC_DUP_VARS);
+			else
+				cscm_syntax_error_report(var->filename,	\
+						var->line,		\
+						CSCM_ERROR_LET_DUP_VARS);
+		}
 	}
 
 
@@ -106,32 +149,253 @@ int cscm_is_let(CSCM_AST_NODE *exp)
 }
 
 
+int cscm_is_let(CSCM_AST_NODE *exp)
+{
+	if (exp == NULL)
+		cscm_error_report("cscm_is_let", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	return _cscm_let_check(exp, "let");
+}
+
+
+int cscm_is_letrec(CSCM_AST_NODE *exp)
+{
+	if (exp == NULL)
+		cscm_error_report("cscm_is_letrec", \
+				CSCM_ERROR_NULL_PTR);
 
 
-CSCM_EF *cscm_analyze_let(CSCM_AST_NODE *exp)
+	return _cscm_let_check(exp, "letrec");
+}
+
+
+
+
+CSCM_LET_EF_STATE *_cscm_let_ef_state_create(CSCM_AST_NODE *bindings)
+{
+	int i;
+	CSCM_AST_NODE *var;
+
+	CSCM_LET_EF_STATE *state;
+
+
+	state = malloc(sizeof(CSCM_LET_EF_STATE));
+	if (state == NULL)
+		cscm_libc_fail("_cscm_let_ef_state_create", "malloc");
+
+
+	state->flag_rec = 0;
+
+	state->n_vars = bindings->n_childs;
+	state->vars = NULL;
+
+	state->init_efs = NULL;
+	state->proc_efs = NULL;
+
+	state->frame_size = 0;
+	state->cells = NULL;
+
+	state->body = NULL;
+
+
+	if (state->n_vars > 0) {
+		state->vars = malloc(state->n_vars * sizeof(char *));
+		if (state->vars == NULL)
+			cscm_libc_fail("_cscm_let_ef_state_create", "malloc");
+
+		for (i = 0; i < state->n_vars; i++) {
+			var = cscm_ast_exp_index(				\
+					cscm_ast_exp_index(bindings, i), 0);
+			state->vars[i] = cscm_symbol_intern_text(var->text);
+		}
+
+
+		state->init_efs = cscm_ef_ptrs_create(state->n_vars);
+		for (i = 0; i < state->n_vars; i++)
+			state->init_efs[i] = NULL;
+	}
+
+
+	return state;
+}
+
+
+/*	Inits are evaluated in env, and the body is executed in a new
+ * frame like the body of a procedure, but no procedure is created. */
+CSCM_OBJECT *_cscm_let_ef(void *state, CSCM_OBJECT *env)
 {
 	int i;
 
-	CSCM_AST_NODE *binding, *bindings;
+	CSCM_LET_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_OBJECT **vals, *frame;
+
+
+	s = (CSCM_LET_EF_STATE *)state;
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	/* vals are not counted until they are stored into the frame */
+	vals = s->n_vars ? cscm_object_ptrs_push(s->n_vars) : NULL;
+	for (i = 0; i < s->n_vars; i++)
+		vals[i] = cscm_ef_exec(s->init_efs[i], env);
+
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	frame = cscm_frame_create(s->frame_size);
+
+	if (s->n_vars > 0) {
+		cscm_frame_init(frame, s->n_vars, s->vars, vals);
+		cscm_object_ptrs_pop(vals);
+	}
+
+	if (s->cells)
+		cscm_frame_make_cells(frame,			\
+				s->cells->n_cells,		\
+				s->cells->slots,		\
+				s->cells->vars);
+
+	env = cscm_env_extend(env, frame);
+	cscm_gc_inc(env);
+
+
+	return cscm_apply_body(s->body, env);
+}
+
+
+/*	All variables are bound to **UNASSIGNED** before inits are
+ * evaluated in the new frame, and procedures which are only applied
+ * are never bound at all. */
+CSCM_OBJECT *_cscm_letrec_ef(void *state, CSCM_OBJECT *env)
+{
+	int i;
+
+	CSCM_LET_EF_STATE *s;
+	int flag_tco_allow;
+
+	CSCM_OBJECT *frame, *val;
+
+
+	s = (CSCM_LET_EF_STATE *)state;
+
+
+	frame = cscm_frame_create(s->frame_size);
+
+	for (i = 0; i < s->n_vars; i++)
+		cscm_frame_add_var(frame, s->vars[i], CSCM_UNASSIGNED);
+
+	if (s->cells)
+		cscm_frame_make_cells(frame,			\
+				s->cells->n_cells,		\
+				s->cells->slots,		\
+				s->cells->vars);
+
+	env = cscm_env_extend(env, frame);
+	cscm_gc_inc(env);
+
+
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+	for (i = 0; i < s->n_vars; i++) {
+		if (s->init_efs[i] == NULL)
+			continue;
+
+		val = cscm_ef_exec(s->init_efs[i], env);
+		cscm_frame_set_var(frame, s->vars[i], val);
+	}
+
+	if (flag_tco_allow) // restore the original value of the flag
+		cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	return cscm_apply_body(s->body, env);
+}
+
+
+
+
+/* the body of exp starts at index first */
+CSCM_AST_NODE *_cscm_let_body_create(CSCM_AST_NODE *exp, size_t first)
+{
+	int i;
+	CSCM_AST_NODE *body;
+
+
+	body = cscm_ast_exp_create(exp->filename, exp->line);
+
+	for (i = first; i < exp->n_childs; i++)
+		cscm_ast_exp_append(body, cscm_ast_exp_index(exp, i));
+
+
+	return body;
+}
+
+
+int _cscm_let_ast_has_symbol(CSCM_AST_NODE *node, char *text)
+{
+	int i;
+
+
+	if (cscm_ast_is_symbol(node))
+		return cscm_ast_symbol_text_equal(node, text);
+
+
+	for (i = 0; i < node->n_childs; i++)
+		if (_cscm_let_ast_has_symbol(cscm_ast_exp_index(node, i), text))
+			return 1;
+
+	return 0;
+}
+
+
+/*	(let name ((var init) ...) body ...) is transformed into
+ *	(letrec ((name (lambda (var ...) body ...))) (name init ...)),
+ * or ((letrec ((name (lambda (var ...) body ...))) name) init ...)
+ * when inits may refer to another variable called name. */
+CSCM_EF *_cscm_analyze_named_let(CSCM_AST_NODE *exp)
+{
+	int i;
+
+	CSCM_AST_NODE *name, *binding, *bindings;
 	CSCM_AST_NODE *param, *arg;
 
-	CSCM_AST_NODE *proc, *lambda, *params;
-	CSCM_AST_NODE *combination, *args;
+	CSCM_AST_NODE *lambda, *params, *args, *keyword;
+	CSCM_AST_NODE *letrec, *letrec_binding, *letrec_bindings;
+	CSCM_AST_NODE *operator;
+
+	int flag_shadowed;
 
 
 	cscm_ast_free_symbol(cscm_ast_exp_index(exp, 0)); // symbol: "let"
 
 
+	name = cscm_ast_exp_index(exp, 1);
+
 	params = cscm_ast_exp_create("<transformation>", 0);
 	args = cscm_ast_exp_create("<transformation>", 0);
 
-	bindings = cscm_ast_exp_index(exp, 1);
+	flag_shadowed = 0;
+
+	bindings = cscm_ast_exp_index(exp, 2);
 	for (i = 0; i < bindings->n_childs; i++) {
 		binding = cscm_ast_exp_index(bindings, i);
 
 		param = cscm_ast_exp_index(binding, 0);
 		arg = cscm_ast_exp_index(binding, 1);
 
+		if (_cscm_let_ast_has_symbol(arg, name->text))
+			flag_shadowed = 1;
+
 		cscm_ast_exp_append(params, param);
 		cscm_ast_exp_append(args, arg);
 
@@ -143,30 +407,311 @@ CSCM_EF *cscm_analyze_let(CSCM_AST_NODE *exp)
 
 
 	/* constructing the new lambda expression */
-	proc = cscm_ast_exp_create("<transformation>", 0);
+	lambda = cscm_ast_exp_create("<transformation>", 0);
+
+	keyword = cscm_ast_symbol_create("<transformation>", 0);
+	cscm_ast_symbol_set(keyword, "lambda");
+
+	cscm_ast_exp_append(lambda, keyword);
+	cscm_ast_exp_append(lambda, params);
 
-	lambda = cscm_ast_symbol_create("<transformation>", 0);
-	cscm_ast_symbol_set(lambda, "lambda");
+	for (i = 3; i < exp->n_childs; i++) // append body
+		cscm_ast_exp_append(lambda, cscm_ast_exp_index(exp, i));
 
-	cscm_ast_exp_append(proc, lambda);
-	cscm_ast_exp_append(proc, params);
 
-	for (i = 2; i < exp->n_childs; i++) // append body
-		cscm_ast_exp_append(proc, cscm_ast_exp_index(exp, i));
+	/* constructing the new letrec expression */
+	letrec_binding = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(letrec_binding, name);
+	cscm_ast_exp_append(letrec_binding, lambda);
 
+	letrec_bindings = cscm_ast_exp_create("<transformation>", 0);
+	cscm_ast_exp_append(letrec_bindings, letrec_binding);
 
-	/* constructing the new combination */
-	cscm_ast_exp_insert_first(args, proc);
-	combination = args;
+	letrec = cscm_ast_exp_create("<transformation>", 0);
+
+	keyword = cscm_ast_symbol_create("<transformation>", 0);
+	cscm_ast_symbol_set(keyword, "letrec");
+
+	cscm_ast_exp_append(letrec, keyword);
+	cscm_ast_exp_append(letrec, letrec_bindings);
+
+
+	operator = cscm_ast_symbol_create("<transformation>", 0);
+	cscm_ast_symbol_set(operator, name->text);
+
+	if (flag_shadowed) {
+		cscm_ast_exp_append(letrec, operator);
+		cscm_ast_exp_insert_first(args, letrec);
+	} else {
+		cscm_ast_exp_insert_first(args, operator);
+		cscm_ast_exp_append(letrec, args);
+
+		args = letrec;
+	}
 
 
-	/*	The reason of moving combination to exp is that
+	/*	The reason of moving the new expression to exp is that
 	 * we'll free the original ast tree after analyzing the
 	 * entire script and this recursive process will try to
-	 * free only some parts of the newly created combination
-	 * but not all if we don't move. */
-	cscm_ast_exp_mv(combination, exp);
+	 * free only some parts of the new expression but not all
+	 * if we don't move. */
+	cscm_ast_exp_mv(args, exp);
+
+
+	if (flag_shadowed)
+		return cscm_analyze_combination(exp);
+	else
+		return cscm_analyze_letrec(exp);
+}
+
+
+CSCM_EF *cscm_analyze_let(CSCM_AST_NODE *exp)
+{
+	int i;
+	CSCM_AST_NODE *bindings, *init, *body;
+
+	CSCM_LET_EF_STATE *state;
+
+
+	if (cscm_ast_is_symbol(cscm_ast_exp_index(exp, 1)))
+		return _cscm_analyze_named_let(exp);
+
+
+	bindings = cscm_ast_exp_index(exp, 1);
+
+	state = _cscm_let_ef_state_create(bindings);
+
+	for (i = 0; i < state->n_vars; i++) {
+		init = cscm_ast_exp_index(cscm_ast_exp_index(bindings, i), 1);
+		state->init_efs[i] = cscm_analyze(init);
+	}
+
+
+	body = _cscm_let_body_create(exp, 2);
+
+	/* the body is analyzed like the body of a lambda expression */
+	cscm_scope_enter(state->n_vars, state->vars);
+
+	for (i = 0; i < body->n_childs; i++)
+		if (cscm_is_definition(cscm_ast_exp_index(body, i)))
+			cscm_scope_add_definition(cscm_ast_exp_index(body, i));
+
+	cscm_scope_scan_body(exp, 2);
+
+	state->frame_size = cscm_scope_get_n_vars();
+
+	state->body = cscm_analyze_seq(body);
+
+	state->cells = cscm_scope_get_cells();
+
+	cscm_scope_leave();
+
+	cscm_ast_free_exp(body);
+
+
+	return cscm_ef_construct(CSCM_EF_TYPE_LET,	\
+				state,			\
+				exp,			\
+				_cscm_let_ef);
+}
+
+
+/*	Whether var is found in node where it is not the operator of a
+ * combination, or is bound again by a definition. Quoted data are
+ * skipped, and every other list is treated like a combination. */
+int _cscm_letrec_ast_has_value(CSCM_AST_NODE *node, char *var)
+{
+	int i;
+	CSCM_AST_NODE *head, *header;
+
+
+	if (cscm_ast_is_symbol(node))
+		return cscm_ast_symbol_text_equal(node, var);
+	else if (cscm_ast_is_exp_empty(node))
+		return 0;
+
+
+	head = cscm_ast_exp_index(node, 0);
+	if (!cscm_ast_is_symbol(head)) {
+		i = 0;
+	} else if (cscm_ast_symbol_text_equal(head, "quote")) {
+		return 0;
+	} else {
+		if (cscm_ast_symbol_text_equal(head, "define")		\
+			&& node->n_childs > 1) {
+			header = cscm_ast_exp_index(node, 1);
+			if (cscm_ast_is_exp(header)			\
+				&& !cscm_ast_is_exp_empty(header)	\
+				&& _cscm_letrec_ast_has_value(		\
+					cscm_ast_exp_index(header, 0), var))
+				return 1;
+		}
+
+		i = 1;
+	}
+
+	for (; i < node->n_childs; i++)
+		if (_cscm_letrec_ast_has_value(				\
+				cscm_ast_exp_index(node, i), var))
+			return 1;
+
+	return 0;
+}
+
+
+/*	Variables bound to lambda expressions, which are not found to
+ * be used as values by a syntactic pass, are assumed to be only
+ * applied, unless the scope is dynamic. Calls to them are analyzed
+ * into combinations which apply their lambda expressions directly.
+ *	A variable may still turn out to be used as a value by the
+ * analysis, e.g. when it is applied in a flat closure which has to
+ * capture it. Its lambda expression, which is analyzed to keep the
+ * whole environment, is then evaluated as its init as well. */
+CSCM_EF *cscm_analyze_letrec(CSCM_AST_NODE *exp)
+{
+	int i, j;
+	size_t n_closures;
+	CSCM_AST_NODE *bindings, *init, *body;
+
+	CSCM_LET_EF_STATE *state;
+
+
+	bindings = cscm_ast_exp_index(exp, 1);
+
+	state = _cscm_let_ef_state_create(bindings);
+	state->flag_rec = 1;
+
+	if (state->n_vars > 0) {
+		state->proc_efs = cscm_ef_ptrs_create(state->n_vars);
+		for (i = 0; i < state->n_vars; i++)
+			state->proc_efs[i] = NULL;
+	}
+
+
+	body = _cscm_let_body_create(exp, 2);
+
+	cscm_scope_enter(state->n_vars, state->vars);
+
+	for (i = 0; i < body->n_childs; i++)
+		if (cscm_is_definition(cscm_ast_exp_index(body, i)))
+			cscm_scope_add_definition(cscm_ast_exp_index(body, i));
+
+	/* inits are analyzed in the new scope too */
+	for (i = 0; i < state->n_vars; i++)
+		cscm_scope_scan_exp(cscm_ast_exp_index(			\
+				cscm_ast_exp_index(bindings, i), 1));
+
+	cscm_scope_scan_body(exp, 2);
+
+	for (i = 0; i < state->n_vars; i++) {
+		init = cscm_ast_exp_index(cscm_ast_exp_index(bindings, i), 1);
+
+		/* closures may capture it before its init is stored */
+		cscm_scope_add_assignment(state->vars[i]);
+
+		if (cscm_scope_is_dynamic() || !cscm_is_lambda(init))
+			continue;
+
+		for (j = 0; j < state->n_vars; j++)
+			if (_cscm_letrec_ast_has_value(			\
+					cscm_ast_exp_index(		\
+					cscm_ast_exp_index(bindings, j), 1), \
+					state->vars[i]))
+				break;
+
+		if (j == state->n_vars					\
+			&& !_cscm_letrec_ast_has_value(body, state->vars[i]))
+			cscm_scope_add_proc(state->vars[i],		\
+					&state->proc_efs[i]);
+	}
+
+	state->frame_size = cscm_scope_get_n_vars();
+
+
+	for (i = 0; i < state->n_vars; i++) {
+		init = cscm_ast_exp_index(cscm_ast_exp_index(bindings, i), 1);
+
+		if (cscm_scope_get_proc(state->vars[i]))
+			state->proc_efs[i] = cscm_analyze_lambda_known(init);
+		else
+			state->init_efs[i] = cscm_analyze(init);
+	}
+
+	state->body = cscm_analyze_seq(body);
+
+	/* known procedures never create procedure objects */
+	n_closures = cscm_scope_get_n_closures();
+	for (i = 0; i < state->n_vars; i++) {
+		if (state->proc_efs[i] == NULL)
+			continue;
+		else if (cscm_scope_get_proc(state->vars[i]))
+			n_closures--;
+		else
+			state->init_efs[i] = state->proc_efs[i];
+	}
+
+	cscm_scope_set_n_closures(n_closures);
+
+	state->cells = cscm_scope_get_cells();
+
+	cscm_scope_leave();
+
+	cscm_ast_free_exp(body);
+
+
+	return cscm_ef_construct(CSCM_EF_TYPE_LET,	\
+				state,			\
+				exp,			\
+				_cscm_letrec_ef);
+}
+
+
+
+
+void cscm_let_ef_free(CSCM_EF *ef)
+{
+	int i;
+
+	CSCM_LET_EF_STATE *state;
+
+
+	if (ef == NULL)
+		cscm_error_report("cscm_let_ef_free", \
+				CSCM_ERROR_NULL_PTR);
+	else if (ef->type != CSCM_EF_TYPE_LET)
+		cscm_error_report("cscm_let_ef_free", \
+				CSCM_ERROR_EF_TYPE);
+
+
+	state = (CSCM_LET_EF_STATE *)ef->state;
+
+
+	for (i = 0; i < state->n_vars; i++) {
+		if (state->proc_efs && state->proc_efs[i]		\
+			&& state->proc_efs[i] != state->init_efs[i])
+			cscm_ef_free_tree(state->proc_efs[i]);
+
+		if (state->init_efs[i])
+			cscm_ef_free_tree(state->init_efs[i]);
+	}
+
+	cscm_ef_free_tree(state->body);
+
+
+	if (state->vars) // the variables are interned
+		free(state->vars);
+
+	if (state->init_efs)
+		free(state->init_efs);
+
+	if (state->proc_efs)
+		free(state->proc_efs);
+
+	if (state->cells)
+		cscm_scope_cells_free(state->cells);
+
+	free(state);
 
 
-	return cscm_analyze_combination(exp);
+	free(ef);
 }
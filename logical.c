@@ -74,6 +74,8 @@ CSCM_AO_EF_STATE *_cscm_ao_ef_state_create()
 				"malloc");
 
 
+	state->flag_or = 0;
+
 	state->n_clause_efs = 0;
 	state->clause_efs = NULL;
 
@@ -166,7 +168,9 @@ CSCM_EF *cscm_analyze_ao(CSCM_AST_NODE *exp)
 
 
 	type = cscm_ast_exp_index(exp, 0);
-	if (cscm_ast_symbol_text_equal(type, "and"))
+	state->flag_or = !cscm_ast_symbol_text_equal(type, "and");
+
+	if (!state->flag_or)
 		return cscm_ef_construct(CSCM_EF_TYPE_AO,	\
 					state,			\
 					exp,			\
@@ -0,0 +1,572 @@
+/* mem.c -- memory allocator for runtime objects
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "error.h"
+#include "mem.h"
+
+
+
+
+CSCM_MEM_CLASS _cscm_mem_class_list[CSCM_MEM_N_CLASSES];
+
+
+CSCM_MEM_STACK_CHUNK *_cscm_mem_stack = NULL;
+CSCM_MEM_STACK_CHUNK *_cscm_mem_stack_spare = NULL; // avoid thrashing
+
+
+char *_cscm_mem_frames = NULL; // bottom of the frame stack
+char *_cscm_mem_frames_top = NULL;
+char *_cscm_mem_frames_end = NULL;
+
+
+/* total bytes ever requested, used to pace garbage collections */
+size_t _cscm_mem_n_allocated = 0;
+
+
+
+
+/*	Blocks start right behind the header, aligned to the granule.
+ * A freed block is linked through its first word. */
+#define _CSCM_MEM_SLAB_HEADER_SIZE					\
+	((sizeof(CSCM_MEM_SLAB) + CSCM_MEM_GRANULE - 1)			\
+		/ CSCM_MEM_GRANULE * CSCM_MEM_GRANULE)
+
+
+#ifdef __CSCM_MEM_MALLOC__
+	#define _CSCM_MEM_BY_MALLOC(size)	1
+#else
+	#define _CSCM_MEM_BY_MALLOC(size)	((size) > CSCM_MEM_MAX_SIZE)
+#endif
+
+
+#define _CSCM_MEM_STACK_CHUNK_HEADER_SIZE				\
+	((sizeof(CSCM_MEM_STACK_CHUNK) + CSCM_MEM_GRANULE - 1)		\
+		/ CSCM_MEM_GRANULE * CSCM_MEM_GRANULE)
+
+#define _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk)				\
+	((char *)(chunk) + _CSCM_MEM_STACK_CHUNK_HEADER_SIZE)
+
+
+/*	Every block of the frame stack is followed by a word holding
+ * its size with the whole word included, and the lowest bit of this
+ * word is set when the block has been popped. */
+#define _CSCM_MEM_FRAME_SIZE(size)					\
+	(((size) + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t) \
+		+ sizeof(size_t))
+
+#define _CSCM_MEM_FRAME_TRAILER(end)	(((size_t *)(end))[-1])
+
+#define _CSCM_MEM_FRAME_DEAD		((size_t)1)
+
+
+#define _CSCM_MEM_BLOCK_LINK(block)	(((void **)(block))[0])
+
+
+#define _CSCM_MEM_BLOCK_SIZE(class)	(((class) + 1) * CSCM_MEM_GRANULE)
+
+
+#define _CSCM_MEM_N_BLOCKS(class)					\
+	((CSCM_MEM_SLAB_SIZE - _CSCM_MEM_SLAB_HEADER_SIZE)		\
+		/ _CSCM_MEM_BLOCK_SIZE(class))
+
+
+
+
+void _cscm_mem_slab_push(CSCM_MEM_SLAB **list, CSCM_MEM_SLAB *slab)
+{
+	slab->prev = NULL;
+	slab->next = *list;
+
+	if (*list)
+		(*list)->prev = slab;
+
+	*list = slab;
+}
+
+
+void _cscm_mem_slab_remove(CSCM_MEM_SLAB **list, CSCM_MEM_SLAB *slab)
+{
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		*list = slab->next;
+
+	if (slab->next)
+		slab->next->prev = slab->prev;
+
+
+	slab->prev = NULL;
+	slab->next = NULL;
+}
+
+
+
+
+void _cscm_mem_slab_reset(CSCM_MEM_SLAB *slab)
+{
+	slab->n_used = 0;
+
+	slab->free_list = NULL;
+	slab->bump = (char *)slab + _CSCM_MEM_SLAB_HEADER_SIZE;
+}
+
+
+CSCM_MEM_SLAB *_cscm_mem_slab_create(size_t class)
+{
+	void *mem;
+	CSCM_MEM_SLAB *slab;
+
+
+	if (posix_memalign(&mem, CSCM_MEM_SLAB_SIZE, CSCM_MEM_SLAB_SIZE))
+		cscm_libc_fail("_cscm_mem_slab_create", "posix_memalign");
+
+
+	slab = (CSCM_MEM_SLAB *)mem;
+
+	slab->class = class;
+	slab->n_blocks = _CSCM_MEM_N_BLOCKS(class);
+
+	_cscm_mem_slab_reset(slab);
+	slab->end = slab->bump					\
+			+ slab->n_blocks * _CSCM_MEM_BLOCK_SIZE(class);
+
+	slab->prev = NULL;
+	slab->next = NULL;
+
+
+	return slab;
+}
+
+
+
+
+void *_cscm_mem_large_alloc(size_t size)
+{
+	void *ptr;
+
+
+	ptr = malloc(size);
+	if (ptr == NULL)
+		cscm_libc_fail("_cscm_mem_large_alloc", "malloc");
+
+
+	return ptr;
+}
+
+
+void _cscm_mem_large_free(void *ptr)
+{
+	free(ptr);
+}
+
+
+
+
+void *cscm_mem_alloc(size_t size)
+{
+	void *ptr;
+	size_t class;
+
+	CSCM_MEM_CLASS *c;
+	CSCM_MEM_SLAB *slab;
+
+
+	if (size == 0)
+		cscm_error_report("cscm_mem_alloc", \
+				CSCM_ERROR_MEM_ZERO_SIZE);
+
+
+	_cscm_mem_n_allocated += size;
+
+
+	if (_CSCM_MEM_BY_MALLOC(size))
+		return _cscm_mem_large_alloc(size);
+
+
+	class = (size - 1) / CSCM_MEM_GRANULE;
+	c = &_cscm_mem_class_list[class];
+
+
+	slab = c->partial;
+	if (slab == NULL) {
+		if (c->empty) {
+			slab = c->empty;
+			c->empty = NULL;
+		} else {
+			slab = _cscm_mem_slab_create(class);
+			c->n_slabs++;
+		}
+
+		_cscm_mem_slab_push(&c->partial, slab);
+	}
+
+
+	if (slab->free_list) {
+		ptr = slab->free_list;
+		slab->free_list = _CSCM_MEM_BLOCK_LINK(ptr);
+	} else {
+		ptr = slab->bump;
+		slab->bump += _CSCM_MEM_BLOCK_SIZE(class);
+	}
+
+	slab->n_used++;
+	c->n_used++;
+
+
+	if (slab->n_used == slab->n_blocks) // full
+		_cscm_mem_slab_remove(&c->partial, slab);
+
+
+	return ptr;
+}
+
+
+/*	size must be the same as the one requested when ptr was
+ * allocated. A slab becoming empty is kept for reuse when its class
+ * has no empty slab yet, otherwise it is released at once. */
+void cscm_mem_free(void *ptr, size_t size)
+{
+	size_t class;
+
+	CSCM_MEM_CLASS *c;
+	CSCM_MEM_SLAB *slab;
+
+
+	if (ptr == NULL)
+		cscm_error_report("cscm_mem_free", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (_CSCM_MEM_BY_MALLOC(size)) {
+		_cscm_mem_large_free(ptr);
+		return;
+	}
+
+
+	class = (size - 1) / CSCM_MEM_GRANULE;
+	c = &_cscm_mem_class_list[class];
+
+	slab = (CSCM_MEM_SLAB *)((uintptr_t)ptr			\
+				& ~(uintptr_t)(CSCM_MEM_SLAB_SIZE - 1));
+	if (slab->class != class || (char *)ptr >= slab->end)
+		cscm_error_report("cscm_mem_free", \
+				CSCM_ERROR_MEM_BAD_SLAB);
+
+
+	if (slab->n_used == slab->n_blocks) // it was full
+		_cscm_mem_slab_push(&c->partial, slab);
+
+
+	_CSCM_MEM_BLOCK_LINK(ptr) = slab->free_list;
+	slab->free_list = ptr;
+
+	slab->n_used--;
+	c->n_used--;
+
+
+	if (slab->n_used == 0) {
+		_cscm_mem_slab_remove(&c->partial, slab);
+
+		if (c->empty) {
+			free(slab);
+			c->n_slabs--;
+		} else {
+			_cscm_mem_slab_reset(slab);
+			c->empty = slab;
+		}
+	}
+}
+
+
+
+
+CSCM_MEM_STACK_CHUNK *_cscm_mem_stack_chunk_create(size_t size)
+{
+	size_t chunk_size;
+	CSCM_MEM_STACK_CHUNK *chunk;
+
+
+	chunk_size = _CSCM_MEM_STACK_CHUNK_HEADER_SIZE + size;
+	if (chunk_size < CSCM_MEM_STACK_CHUNK_SIZE)
+		chunk_size = CSCM_MEM_STACK_CHUNK_SIZE;
+
+
+	if (_cscm_mem_stack_spare					\
+		&& _cscm_mem_stack_spare->end				\
+			- _CSCM_MEM_STACK_CHUNK_BOTTOM(_cscm_mem_stack_spare) \
+			>= size) {
+		chunk = _cscm_mem_stack_spare;
+		_cscm_mem_stack_spare = NULL;
+	} else {
+		chunk = malloc(chunk_size);
+		if (chunk == NULL)
+			cscm_libc_fail("_cscm_mem_stack_chunk_create", \
+					"malloc");
+
+		chunk->end = (char *)chunk + chunk_size;
+	}
+
+
+	chunk->top = _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk);
+
+	chunk->prev = _cscm_mem_stack;
+	_cscm_mem_stack = chunk;
+
+
+	return chunk;
+}
+
+
+void *cscm_mem_stack_push(size_t size)
+{
+	void *ptr;
+	CSCM_MEM_STACK_CHUNK *chunk;
+
+
+	if (size == 0)
+		cscm_error_report("cscm_mem_stack_push", \
+				CSCM_ERROR_MEM_ZERO_SIZE);
+
+
+	/* no padding between blocks, which are walked as a whole */
+	size = (size + sizeof(void *) - 1)			\
+		/ sizeof(void *) * sizeof(void *);
+
+
+	#ifdef __CSCM_MEM_MALLOC__
+		/* a chunk of its own for every block */
+		chunk = malloc(_CSCM_MEM_STACK_CHUNK_HEADER_SIZE + size);
+		if (chunk == NULL)
+			cscm_libc_fail("cscm_mem_stack_push", "malloc");
+
+		chunk->top = _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk) + size;
+		chunk->end = chunk->top;
+
+		chunk->prev = _cscm_mem_stack;
+		_cscm_mem_stack = chunk;
+
+		return _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk);
+	#endif
+
+
+	chunk = _cscm_mem_stack;
+	if (chunk == NULL || chunk->end - chunk->top < size)
+		chunk = _cscm_mem_stack_chunk_create(size);
+
+
+	ptr = chunk->top;
+	chunk->top += size;
+
+
+	return ptr;
+}
+
+
+/*	ptr must be the last block pushed but not popped yet. */
+void cscm_mem_stack_pop(void *ptr)
+{
+	CSCM_MEM_STACK_CHUNK *chunk;
+
+
+	if (ptr == NULL)
+		cscm_error_report("cscm_mem_stack_pop", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	chunk = _cscm_mem_stack;
+	if (chunk == NULL						\
+		|| (char *)ptr < _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk)	\
+		|| (char *)ptr >= chunk->top)
+		cscm_error_report("cscm_mem_stack_pop", \
+				CSCM_ERROR_MEM_STACK_ORDER);
+
+
+	#ifdef __CSCM_MEM_MALLOC__
+		if ((char *)ptr != _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk))
+			cscm_error_report("cscm_mem_stack_pop", \
+					CSCM_ERROR_MEM_STACK_ORDER);
+
+		_cscm_mem_stack = chunk->prev;
+		free(chunk);
+
+		return;
+	#endif
+
+
+	chunk->top = ptr;
+
+
+	/* the first chunk is always kept */
+	if (chunk->top == _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk) && chunk->prev) {
+		_cscm_mem_stack = chunk->prev;
+
+		if (_cscm_mem_stack_spare)
+			free(_cscm_mem_stack_spare);
+
+		_cscm_mem_stack_spare = chunk;
+	}
+}
+
+
+
+
+/* f is called with the used part of every chunk */
+void cscm_mem_stack_walk(CSCM_MEM_STACK_WALK_FUNC f)
+{
+	char *bottom;
+	CSCM_MEM_STACK_CHUNK *chunk;
+
+
+	if (f == NULL)
+		cscm_error_report("cscm_mem_stack_walk", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	for (chunk = _cscm_mem_stack; chunk; chunk = chunk->prev) {
+		bottom = _CSCM_MEM_STACK_CHUNK_BOTTOM(chunk);
+
+		if (chunk->top > bottom)
+			f(bottom, chunk->top - bottom);
+	}
+}
+
+
+
+
+/*	Return NULL when the frame stack has no room for size bytes,
+ * and the caller should turn to cscm_mem_alloc() then. The frame
+ * stack is never used when all allocations are routed to malloc. */
+void *cscm_mem_frame_push(size_t size)
+{
+	void *ptr;
+
+
+	if (size == 0)
+		cscm_error_report("cscm_mem_frame_push", \
+				CSCM_ERROR_MEM_ZERO_SIZE);
+
+
+	#ifdef __CSCM_MEM_MALLOC__
+		return NULL;
+	#endif
+
+
+	if (_cscm_mem_frames == NULL) {
+		_cscm_mem_frames = malloc(CSCM_MEM_FRAME_STACK_SIZE);
+		if (_cscm_mem_frames == NULL)
+			cscm_libc_fail("cscm_mem_frame_push", "malloc");
+
+		_cscm_mem_frames_top = _cscm_mem_frames;
+		_cscm_mem_frames_end = _cscm_mem_frames			\
+					+ CSCM_MEM_FRAME_STACK_SIZE;
+	}
+
+
+	size = _CSCM_MEM_FRAME_SIZE(size);
+	if (_cscm_mem_frames_end - _cscm_mem_frames_top < size)
+		return NULL;
+
+
+	ptr = _cscm_mem_frames_top;
+	_cscm_mem_frames_top += size;
+
+	_CSCM_MEM_FRAME_TRAILER(_cscm_mem_frames_top) = size;
+
+
+	return ptr;
+}
+
+
+/*	Return 0 when ptr is not on the frame stack, otherwise the
+ * block of size bytes is popped. A block popped below the top is only
+ * marked, and reclaimed when all blocks above it have been popped. */
+int cscm_mem_frame_pop(void *ptr, size_t size)
+{
+	size_t trailer;
+
+
+	if (!cscm_mem_frame_has(ptr))
+		return 0;
+
+
+	_CSCM_MEM_FRAME_TRAILER((char *)ptr + _CSCM_MEM_FRAME_SIZE(size)) \
+		|= _CSCM_MEM_FRAME_DEAD;
+
+
+	while (_cscm_mem_frames_top > _cscm_mem_frames) {
+		trailer = _CSCM_MEM_FRAME_TRAILER(_cscm_mem_frames_top);
+		if (!(trailer & _CSCM_MEM_FRAME_DEAD))
+			break;
+
+		_cscm_mem_frames_top -= trailer & ~_CSCM_MEM_FRAME_DEAD;
+	}
+
+
+	return 1;
+}
+
+
+int cscm_mem_frame_has(void *ptr)
+{
+	return (char *)ptr >= _cscm_mem_frames		\
+		&& (char *)ptr < _cscm_mem_frames_top;
+}
+
+
+
+
+size_t cscm_mem_get_n_allocated()
+{
+	return _cscm_mem_n_allocated;
+}
+
+
+void cscm_mem_print_occupancy(FILE *stream)
+{
+	size_t class;
+	CSCM_MEM_CLASS *c;
+
+
+	if (stream == NULL)
+		cscm_error_report("cscm_mem_print_occupancy", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	#ifdef __CSCM_MEM_MALLOC__
+		fputs("all blocks are allocated by malloc\n", stream);
+		return;
+	#endif
+
+
+	for (class = 0; class < CSCM_MEM_N_CLASSES; class++) {
+		c = &_cscm_mem_class_list[class];
+		if (c->n_slabs == 0)
+			continue;
+
+		fprintf(stream,						\
+			"class %3lu bytes: %lu slabs, %lu/%lu blocks used\n", \
+			(unsigned long)_CSCM_MEM_BLOCK_SIZE(class),	\
+			(unsigned long)c->n_slabs,			\
+			(unsigned long)c->n_used,			\
+			(unsigned long)(c->n_slabs			\
+					* _CSCM_MEM_N_BLOCKS(class)));
+	}
+}
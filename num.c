@@ -29,25 +29,26 @@
 
 
 
-CSCM_OBJECT *cscm_num_long_create()
+/*	Longs in the fixnum range are returned as immediate objects,
+ * and only the others are allocated on the heap. */
+CSCM_OBJECT *cscm_num_long_create(long val)
 {
 	long *l;
 	CSCM_OBJECT *obj;
 
 
-	obj = cscm_object_create();
+	if (CSCM_FIXNUM_FITS(val))
+		return CSCM_FIXNUM_MAKE(val);
 
 
-	l = malloc(sizeof(long));
-	if (l == NULL)
-		cscm_libc_fail("cscm_num_long_create", "malloc");
+	obj = cscm_object_create_inline(sizeof(long));
 
 
-	*l = 0;
+	l = (long *)obj->value;
+	*l = val;
 
 
 	obj->type = CSCM_OBJECT_TYPE_NUM_LONG;
-	obj->value = l;
 
 
 	return obj;
@@ -60,19 +61,14 @@ CSCM_OBJECT *cscm_num_double_create()
 	CSCM_OBJECT *obj;
 
 
-	obj = cscm_object_create();
-
-
-	d = malloc(sizeof(double));
-	if (d == NULL)
-		cscm_libc_fail("cscm_num_double_create", "malloc");
+	obj = cscm_object_create_inline(sizeof(double));
 
 
+	d = (double *)obj->value;
 	*d = 0.0;
 
 
 	obj->type = CSCM_OBJECT_TYPE_NUM_DOUBLE;
-	obj->value = d;
 
 
 	return obj;
@@ -81,29 +77,6 @@ CSCM_OBJECT *cscm_num_double_create()
 
 
 
-void cscm_num_long_set(CSCM_OBJECT *num, long val)
-{
-	long *l;
-
-
-	if (num == NULL)
-		cscm_error_report("cscm_num_long_set", \
-				CSCM_ERROR_NULL_PTR);
-	else if (num->type != CSCM_OBJECT_TYPE_NUM_LONG)
-		cscm_error_report("cscm_num_long_set", \
-				CSCM_ERROR_OBJECT_TYPE);
-	else if (num->value == NULL)
-		cscm_error_report("cscm_num_long_set", \
-				CSCM_ERROR_EMPTY_OBJECT);
-
-
-	l = (long *)num->value;
-
-
-	*l = val;
-}
-
-
 void cscm_num_double_set(CSCM_OBJECT *num, double val)
 {
 	double *d;
@@ -112,7 +85,7 @@ void cscm_num_double_set(CSCM_OBJECT *num, double val)
 	if (num == NULL)
 		cscm_error_report("cscm_num_double_set", \
 				CSCM_ERROR_NULL_PTR);
-	else if (num->type != CSCM_OBJECT_TYPE_NUM_DOUBLE)
+	else if (CSCM_OBJECT_GET_TYPE(num) != CSCM_OBJECT_TYPE_NUM_DOUBLE)
 		cscm_error_report("cscm_num_double_set", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (num->value == NULL)
@@ -137,7 +110,9 @@ long cscm_num_long_get(CSCM_OBJECT *num)
 	if (num == NULL)
 		cscm_error_report("cscm_num_long_get", \
 				CSCM_ERROR_NULL_PTR);
-	else if (num->type != CSCM_OBJECT_TYPE_NUM_LONG)
+	else if (CSCM_OBJECT_IS_FIXNUM(num))
+		return CSCM_FIXNUM_GET(num);
+	else if (CSCM_OBJECT_GET_TYPE(num) != CSCM_OBJECT_TYPE_NUM_LONG)
 		cscm_error_report("cscm_num_long_get", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (num->value == NULL)
@@ -160,7 +135,7 @@ double cscm_num_double_get(CSCM_OBJECT *num)
 	if (num == NULL)
 		cscm_error_report("cscm_num_double_get", \
 				CSCM_ERROR_NULL_PTR);
-	else if (num->type != CSCM_OBJECT_TYPE_NUM_DOUBLE)
+	else if (CSCM_OBJECT_GET_TYPE(num) != CSCM_OBJECT_TYPE_NUM_DOUBLE)
 		cscm_error_report("cscm_num_double_get", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (num->value == NULL)
@@ -186,10 +161,12 @@ void cscm_num_print(CSCM_OBJECT *obj, FILE *stream)
 	if (obj == NULL || stream == NULL) {
 		cscm_error_report("cscm_num_print", \
 				CSCM_ERROR_NULL_PTR);
-	} else if (obj->type == CSCM_OBJECT_TYPE_NUM_LONG) {
+	} else if (CSCM_OBJECT_IS_FIXNUM(obj)) {
+		printf("%ld", CSCM_FIXNUM_GET(obj));
+	} else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NUM_LONG) {
 		l = (long *)obj->value;
 		printf("%ld", *l);
-	} else if (obj->type == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
+	} else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NUM_DOUBLE) {
 		d = (double *)obj->value;
 		printf("%.2f", *d);
 	} else {
@@ -256,8 +233,7 @@ CSCM_EF *cscm_analyze_num_long(CSCM_AST_NODE *exp)
 	number = atol(exp->text);
 
 
-	number_obj = cscm_num_long_create();
-	cscm_num_long_set(number_obj, number);
+	number_obj = cscm_num_long_create(number);
 
 
 	/*	The execution function only has 1 copy of this
@@ -339,13 +315,14 @@ void cscm_num_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_num_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_EF_TYPE_NUM_LONG \
-		&& obj->type != CSCM_EF_TYPE_NUM_DOUBLE)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_EF_TYPE_NUM_LONG \
+		&& CSCM_OBJECT_GET_TYPE(obj) != CSCM_EF_TYPE_NUM_DOUBLE)
 		cscm_error_report("cscm_num_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	free(obj->value); // pointed to memories allocated when created
-
-	free(obj);
+	if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NUM_LONG)
+		cscm_object_destroy_inline(obj, sizeof(long));
+	else
+		cscm_object_destroy_inline(obj, sizeof(double));
 }
@@ -28,6 +28,8 @@
 #include "num.h"
 #include "gc.h"
 #include "pair.h"
+#include "mem.h"
+#include "cell.h"
 
 
 
@@ -37,14 +39,67 @@ CSCM_OBJECT *cscm_object_create()
 	CSCM_OBJECT *obj;
 
 
-	obj = malloc(sizeof(CSCM_OBJECT));
-	if (obj == NULL)
-		cscm_libc_fail("cscm_object_create", "malloc");
+	obj = cscm_mem_alloc(sizeof(CSCM_OBJECT));
 
 
 	obj->type = CSCM_OBJECT_TYPE_NONE;
 	obj->value = NULL;
 	obj->ref_count = 0;
+	obj->gc_refs = 0;
+
+
+	#ifdef __CSCM_GC_DEBUG__
+		cscm_gc_inc_total_object_count();
+	#endif
+
+
+	return obj;
+}
+
+
+/*	The payload of size bytes is stored right behind the header in
+ * the same memory block, and obj->value points to it. Such an object
+ * is released by cscm_object_destroy_inline with the same size. */
+CSCM_OBJECT *cscm_object_create_inline(size_t size)
+{
+	CSCM_OBJECT *obj;
+
+
+	obj = cscm_mem_alloc(sizeof(CSCM_OBJECT) + size);
+
+
+	obj->type = CSCM_OBJECT_TYPE_NONE;
+	obj->value = obj + 1;
+	obj->ref_count = 0;
+	obj->gc_refs = 0;
+
+
+	#ifdef __CSCM_GC_DEBUG__
+		cscm_gc_inc_total_object_count();
+	#endif
+
+
+	return obj;
+}
+
+
+/*	Like cscm_object_create_inline(), but the memory block is taken
+ * from the frame stack when it has room. Only objects which can not
+ * outlive the application creating them should be placed there. */
+CSCM_OBJECT *cscm_object_create_inline_stacked(size_t size)
+{
+	CSCM_OBJECT *obj;
+
+
+	obj = cscm_mem_frame_push(sizeof(CSCM_OBJECT) + size);
+	if (obj == NULL)
+		return cscm_object_create_inline(size);
+
+
+	obj->type = CSCM_OBJECT_TYPE_NONE;
+	obj->value = obj + 1;
+	obj->ref_count = 0;
+	obj->gc_refs = 0;
 
 
 	#ifdef __CSCM_GC_DEBUG__
@@ -56,6 +111,23 @@ CSCM_OBJECT *cscm_object_create()
 }
 
 
+/*	Release the memory of obj itself, which should be called at
+ * last by the free function of each type. */
+void cscm_object_destroy(CSCM_OBJECT *obj)
+{
+	cscm_mem_free(obj, sizeof(CSCM_OBJECT));
+}
+
+
+void cscm_object_destroy_inline(CSCM_OBJECT *obj, size_t size)
+{
+	if (!cscm_mem_frame_pop(obj, sizeof(CSCM_OBJECT) + size))
+		cscm_mem_free(obj, sizeof(CSCM_OBJECT) + size);
+}
+
+
+
+
 CSCM_OBJECT **cscm_object_ptrs_create(size_t n)
 {
 	size_t size;
@@ -78,6 +150,40 @@ CSCM_OBJECT **cscm_object_ptrs_create(size_t n)
 
 
 
+/*	Like cscm_object_ptrs_create(), but the pointers are allocated
+ * from the stack of mem.c, so they must be popped by the same C
+ * function, and in reverse order of their pushes.
+ *	The stack holds live temporaries of the evaluator, and it is
+ * scanned by gc.c, therefore the pointers start as NULL, and must be
+ * NULL or point to objects which have not been freed. */
+CSCM_OBJECT **cscm_object_ptrs_push(size_t n)
+{
+	int i;
+	CSCM_OBJECT **ptrs;
+
+
+	if (n == 0)
+		cscm_error_report("cscm_object_ptrs_push", \
+				CSCM_ERROR_OBJECT_ZERO_PTR);
+
+
+	ptrs = cscm_mem_stack_push(n * sizeof(CSCM_OBJECT *));
+
+	for (i = 0; i < n; i++)
+		ptrs[i] = NULL;
+
+
+	return ptrs;
+}
+
+
+void cscm_object_ptrs_pop(CSCM_OBJECT **ptrs)
+{
+	cscm_mem_stack_pop(ptrs);
+}
+
+
+
 
 CSCM_OBJECT_PRINT_FUNC _cscm_object_print_func_list[] = {
 	cscm_num_print,
@@ -92,24 +198,29 @@ CSCM_OBJECT_PRINT_FUNC _cscm_object_print_func_list[] = {
 	cscm_nil_print,
 	cscm_bool_print,
 	cscm_bool_print,
-	cscm_unassigned_print
+	cscm_unassigned_print,
+	cscm_cell_print
 };
 
 
 void cscm_object_print(CSCM_OBJECT *obj, FILE *stream)
 {
+	int type;
 	CSCM_OBJECT_PRINT_FUNC pf;
 
 
 	if (obj == NULL || stream == NULL)
 		cscm_error_report("cscm_object_print", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type < 0 || obj->type >= CSCM_OBJECT_TYPE_NONE)
+
+
+	type = CSCM_OBJECT_GET_TYPE(obj);
+	if (type < 0 || type >= CSCM_OBJECT_TYPE_NONE)
 		cscm_error_report("cscm_object_print", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	pf = _cscm_object_print_func_list[obj->type];
+	pf = _cscm_object_print_func_list[type];
 	pf(obj, stream);
 }
 
@@ -129,23 +240,28 @@ CSCM_OBJECT_FREE_FUNC _cscm_object_free_func_list[] = {
 	cscm_nil_free,
 	cscm_bool_free,
 	cscm_bool_free,
-	cscm_unassigned_free
+	cscm_unassigned_free,
+	cscm_cell_free
 };
 
 
 void cscm_object_free(CSCM_OBJECT *obj)
 {
+	int type;
 	CSCM_OBJECT_FREE_FUNC ff;
 
 
 	if (obj == NULL)
 		cscm_error_report("cscm_object_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type < 0 || obj->type >= CSCM_OBJECT_TYPE_NONE)
+
+
+	type = CSCM_OBJECT_GET_TYPE(obj);
+	if (type < 0 || type >= CSCM_OBJECT_TYPE_NONE)
 		cscm_error_report("cscm_object_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	ff = _cscm_object_free_func_list[obj->type];
+	ff = _cscm_object_free_func_list[type];
 	ff(obj);
 }
@@ -30,30 +30,21 @@
 
 
 
-/* there is only one copy of nil in cscheme */
-CSCM_OBJECT _cscm_nil = {CSCM_OBJECT_TYPE_NIL, NULL, 0};
-
-
-
-
 CSCM_OBJECT *cscm_pair_create()
 {
 	CSCM_OBJECT *obj;
 	CSCM_PAIR *pair;
 
 
-	pair = malloc(sizeof(CSCM_PAIR));
-	if (pair == NULL)
-		cscm_libc_fail("cscm_pair_create", "malloc");
+	obj = cscm_object_create_inline(sizeof(CSCM_PAIR));
 
-	pair->car = NULL;
-	pair->cdr = NULL;
+	obj->type = CSCM_OBJECT_TYPE_PAIR;
 
 
-	obj = cscm_object_create();
+	pair = (CSCM_PAIR *)obj->value;
 
-	obj->type = CSCM_OBJECT_TYPE_PAIR;
-	obj->value = pair;
+	pair->car = NULL;
+	pair->cdr = NULL;
 
 
 	return obj;
@@ -69,7 +60,7 @@ void cscm_pair_set(CSCM_OBJECT *pair_obj, void *car, void *cdr)
 
 	if (pair_obj == NULL)
 		cscm_error_report("cscm_pair_set", CSCM_ERROR_NULL_PTR);
-	else if (pair_obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(pair_obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_pair_set", CSCM_ERROR_OBJECT_TYPE);
 	else if (pair_obj->value == NULL)
 		cscm_error_report("cscm_pair_set", CSCM_ERROR_EMPTY_OBJECT);
@@ -79,6 +70,11 @@ void cscm_pair_set(CSCM_OBJECT *pair_obj, void *car, void *cdr)
 
 	pair = (CSCM_PAIR *)pair_obj->value;
 
+	/* before the old values are released */
+	cscm_gc_inc(car);
+	cscm_gc_inc(cdr);
+
+
 	if (pair->car) {
 		cscm_gc_dec(pair->car);
 		cscm_gc_free(pair->car);
@@ -92,10 +88,6 @@ void cscm_pair_set(CSCM_OBJECT *pair_obj, void *car, void *cdr)
 
 	pair->car = car;
 	pair->cdr = cdr;
-
-
-	cscm_gc_inc(car);
-	cscm_gc_inc(cdr);
 }
 
 
@@ -106,7 +98,7 @@ void cscm_pair_set_car(CSCM_OBJECT *pair_obj, void *car)
 
 	if (pair_obj == NULL)
 		cscm_error_report("cscm_pair_set_car", CSCM_ERROR_NULL_PTR);
-	else if (pair_obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(pair_obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_pair_set_car", CSCM_ERROR_OBJECT_TYPE);
 	else if (pair_obj->value == NULL)
 		cscm_error_report("cscm_pair_set_car", CSCM_ERROR_EMPTY_OBJECT);
@@ -117,13 +109,14 @@ void cscm_pair_set_car(CSCM_OBJECT *pair_obj, void *car)
 	pair = (CSCM_PAIR *)pair_obj->value;
 
 
+	cscm_gc_inc(car); // before the old value is released
+
 	if (pair->car) {
 		cscm_gc_dec(pair->car);
 		cscm_gc_free(pair->car);
 	}
 
 
-	cscm_gc_inc(car);
 	pair->car = car;
 }
 
@@ -135,7 +128,7 @@ void cscm_pair_set_cdr(CSCM_OBJECT *pair_obj, void *cdr)
 
 	if (pair_obj == NULL)
 		cscm_error_report("cscm_pair_set_cdr", CSCM_ERROR_NULL_PTR);
-	else if (pair_obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(pair_obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_pair_set_cdr", CSCM_ERROR_OBJECT_TYPE);
 	else if (pair_obj->value == NULL)
 		cscm_error_report("cscm_pair_set_cdr", CSCM_ERROR_EMPTY_OBJECT);
@@ -147,13 +140,14 @@ void cscm_pair_set_cdr(CSCM_OBJECT *pair_obj, void *cdr)
 	pair = (CSCM_PAIR *)pair_obj->value;
 
 
+	cscm_gc_inc(cdr); // before the old value is released
+
 	if (pair->cdr) {
 		cscm_gc_dec(pair->cdr);
 		cscm_gc_free(pair->cdr);
 	}
 
 
-	cscm_gc_inc(cdr);
 	pair->cdr = cdr;
 }
 
@@ -167,7 +161,7 @@ void *cscm_pair_get_car(CSCM_OBJECT *pair_obj)
 
 	if (pair_obj == NULL)
 		cscm_error_report("cscm_pair_get_car", CSCM_ERROR_NULL_PTR);
-	else if (pair_obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(pair_obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_pair_get_car", CSCM_ERROR_OBJECT_TYPE);
 	else if (pair_obj->value == NULL)
 		cscm_error_report("cscm_pair_get_car", CSCM_ERROR_EMPTY_OBJECT);
@@ -187,7 +181,7 @@ void *cscm_pair_get_cdr(CSCM_OBJECT *pair_obj)
 
 	if (pair_obj == NULL)
 		cscm_error_report("cscm_pair_get_cdr", CSCM_ERROR_NULL_PTR);
-	else if (pair_obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(pair_obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_pair_get_cdr", CSCM_ERROR_OBJECT_TYPE);
 	else if (pair_obj->value == NULL)
 		cscm_error_report("cscm_pair_get_cdr", CSCM_ERROR_EMPTY_OBJECT);
@@ -283,8 +277,7 @@ CSCM_OBJECT *cscm_list_range(long first, long last, long step)
 	while (first != last) {
 		pair = new_pair;
 
-		number = cscm_num_long_create();
-		cscm_num_long_set(number, first);
+		number = cscm_num_long_create(first);
 
 		new_pair = cscm_pair_create();
 
@@ -295,8 +288,7 @@ CSCM_OBJECT *cscm_list_range(long first, long last, long step)
 	}
 
 
-	number = cscm_num_long_create();
-	cscm_num_long_set(number, last);
+	number = cscm_num_long_create(last);
 
 	cscm_pair_set(new_pair, number, CSCM_NIL);
 
@@ -319,7 +311,7 @@ CSCM_OBJECT *cscm_list_cpy(CSCM_OBJECT *list)
 	if (list == NULL)
 		cscm_error_report("cscm_list_cpy", \
 				CSCM_ERROR_NULL_PTR);
-	else if (list->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(list) != CSCM_OBJECT_TYPE_PAIR \
 		&& list != CSCM_NIL)
 		cscm_error_report("cscm_list_cpy", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -348,7 +340,7 @@ CSCM_OBJECT *cscm_list_cpy(CSCM_OBJECT *list)
 		if (src == NULL)
 			cscm_error_report("cscm_list_cpy", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_list_cpy", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -375,7 +367,7 @@ CSCM_OBJECT *cscm_list_reverse(CSCM_OBJECT *list)
 	if (list == NULL)
 		cscm_error_report("cscm_list_reverse", \
 				CSCM_ERROR_NULL_PTR);
-	else if (list->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(list) != CSCM_OBJECT_TYPE_PAIR \
 		&& list != CSCM_NIL)
 		cscm_error_report("cscm_list_reverse", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -402,7 +394,7 @@ CSCM_OBJECT *cscm_list_reverse(CSCM_OBJECT *list)
 		if (src == NULL)
 			cscm_error_report("cscm_list_reverse", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_list_reverse", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -427,10 +419,10 @@ CSCM_OBJECT *cscm_list_append(CSCM_OBJECT *x, CSCM_OBJECT *y)
 	if (x == NULL || y == NULL)
 		cscm_error_report("cscm_list_append", \
 				CSCM_ERROR_NULL_PTR);
-	else if ((x->type != CSCM_OBJECT_TYPE_PAIR	\
+	else if ((CSCM_OBJECT_GET_TYPE(x) != CSCM_OBJECT_TYPE_PAIR	\
 		&& x != CSCM_NIL)			\
 		||					\
-		(y->type != CSCM_OBJECT_TYPE_PAIR	\
+		(CSCM_OBJECT_GET_TYPE(y) != CSCM_OBJECT_TYPE_PAIR	\
 		&& y != CSCM_NIL))
 		cscm_error_report("cscm_list_append", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -461,7 +453,7 @@ CSCM_OBJECT *cscm_list_append(CSCM_OBJECT *x, CSCM_OBJECT *y)
 		if (src == NULL)
 			cscm_error_report("cscm_list_append", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_list_append", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -484,7 +476,7 @@ CSCM_OBJECT *cscm_list_append(CSCM_OBJECT *x, CSCM_OBJECT *y)
 		if (src == NULL)
 			cscm_error_report("cscm_list_append", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (src->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(src) != CSCM_OBJECT_TYPE_PAIR \
 			&& src != CSCM_NIL)
 			cscm_error_report("cscm_list_append", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -512,7 +504,7 @@ size_t cscm_list_get_len(CSCM_OBJECT *list)
 	if (list == NULL)
 		cscm_error_report("cscm_list_get_len", \
 				CSCM_ERROR_NULL_PTR);
-	else if (list->type != CSCM_OBJECT_TYPE_PAIR \
+	else if (CSCM_OBJECT_GET_TYPE(list) != CSCM_OBJECT_TYPE_PAIR \
 		&& list != CSCM_NIL)
 		cscm_error_report("cscm_list_get_len", \
 				CSCM_ERROR_OBJECT_TYPE);
@@ -534,7 +526,7 @@ size_t cscm_list_get_len(CSCM_OBJECT *list)
 		if (pair == NULL)
 			cscm_error_report("cscm_list_get_len", \
 					CSCM_ERROR_LIST_NOT_SEQ);
-		else if (pair->type != CSCM_OBJECT_TYPE_PAIR \
+		else if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR \
 			&& pair != CSCM_NIL)
 			cscm_error_report("cscm_list_get_len", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -558,7 +550,7 @@ CSCM_OBJECT* cscm_list_index(CSCM_OBJECT *list, size_t index)
 	if (list == NULL)
 		cscm_error_report("cscm_list_index", \
 				CSCM_ERROR_NULL_PTR);
-	else if (list->type != CSCM_OBJECT_TYPE_PAIR) // do not support nil
+	else if (CSCM_OBJECT_GET_TYPE(list) != CSCM_OBJECT_TYPE_PAIR) // do not support nil
 		cscm_error_report("cscm_list_index", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -573,7 +565,7 @@ CSCM_OBJECT* cscm_list_index(CSCM_OBJECT *list, size_t index)
 
 		pair = cscm_pair_get_cdr(pair);
 
-		if (pair->type != CSCM_OBJECT_TYPE_PAIR \
+		if (CSCM_OBJECT_GET_TYPE(pair) != CSCM_OBJECT_TYPE_PAIR \
 			&& pair != CSCM_NIL)
 			cscm_error_report("cscm_list_index", \
 					CSCM_ERROR_LIST_NOT_SEQ);
@@ -603,7 +595,7 @@ CSCM_OBJECT **cscm_list_to_object_ptrs(CSCM_OBJECT *list)
 	if (list == NULL)
 		cscm_error_report("cscm_list_to_object_ptrs", \
 				CSCM_ERROR_NULL_PTR);
-	else if (list->type != CSCM_OBJECT_TYPE_PAIR) // do not support nil
+	else if (CSCM_OBJECT_GET_TYPE(list) != CSCM_OBJECT_TYPE_PAIR) // do not support nil
 		cscm_error_report("cscm_list_to_object_ptrs", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -635,7 +627,7 @@ void cscm_list_print(CSCM_OBJECT *obj, FILE *stream)
 	if (obj == NULL || stream == NULL)
 		cscm_error_report("cscm_list_print", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscm_list_print", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -650,7 +642,7 @@ void cscm_list_print(CSCM_OBJECT *obj, FILE *stream)
 				CSCM_ERROR_NULL_PTR);
 
 
-	while(cdr->type == CSCM_OBJECT_TYPE_PAIR)
+	while(CSCM_OBJECT_GET_TYPE(cdr) == CSCM_OBJECT_TYPE_PAIR)
 	{
 		fputc(' ', stream);
 
@@ -687,7 +679,7 @@ void cscm_nil_print(CSCM_OBJECT *obj, FILE *stream)
 
 	if (obj == CSCM_NIL)
 		fputs("nil", stream);
-	else if (obj->type == CSCM_OBJECT_TYPE_NIL)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NIL)
 		cscm_error_report("cscm_nil_print", \
 				CSCM_ERROR_NIL_EXTRA_COPY);
 	else
@@ -707,8 +699,8 @@ void cscm_nil_free(CSCM_OBJECT *obj)
 
 
 	if (obj == CSCM_NIL)
-		return; // since it is not stored on the heap
-	else if (obj->type == CSCM_OBJECT_TYPE_NIL)
+		return; // since it is an immediate object
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_NIL)
 		cscm_error_report("cscm_nil_free", \
 				CSCM_ERROR_NIL_EXTRA_COPY);
 	else
@@ -727,7 +719,7 @@ void cscm_pair_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_pair_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_PAIR)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_PAIR)
 		cscm_error_report("cscmn_pair_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -745,6 +737,5 @@ void cscm_pair_free(CSCM_OBJECT *obj)
 	}
 
 
-	free(obj->value);
-	free(obj);
+	cscm_object_destroy_inline(obj, sizeof(CSCM_PAIR));
 }
@@ -33,20 +33,16 @@ CSCM_OBJECT *cscm_proc_prim_create()
 	CSCM_OBJECT *obj;
 
 
-	obj = cscm_object_create();
+	obj = cscm_object_create_inline(sizeof(CSCM_PROC_PRIM));
 
 
 	obj->type = CSCM_OBJECT_TYPE_PROC_PRIM;
 
 
-	proc = malloc(sizeof(CSCM_PROC_PRIM));
-	if (proc == NULL)
-		cscm_libc_fail("cscm_proc_prim_create", "malloc");
+	proc = (CSCM_PROC_PRIM *)obj->value;
 
 	proc->f = NULL;
 
-	obj->value = proc;
-
 
 	return obj;
 }
@@ -62,7 +58,7 @@ void cscm_proc_prim_set(CSCM_OBJECT *proc_obj, CSCM_PROC_PRIM_FUNC f)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_prim_set", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_PRIM)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_PRIM)
 		cscm_error_report("cscm_proc_prim_set", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -90,7 +86,7 @@ CSCM_PROC_PRIM_FUNC cscm_proc_prim_get_f(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_prim_get_f", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_PRIM)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_PRIM)
 		cscm_error_report("cscm_proc_prim_get_f", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -113,24 +109,21 @@ CSCM_OBJECT *cscm_proc_comp_create()
 	CSCM_OBJECT *obj;
 
 
-	obj = cscm_object_create();
+	obj = cscm_object_create_inline(sizeof(CSCM_PROC_COMP));
 
 
 	obj->type = CSCM_OBJECT_TYPE_PROC_COMP;
 
 
-	proc = malloc(sizeof(CSCM_PROC_COMP));
-	if (proc == NULL)
-		cscm_libc_fail("cscm_proc_prim_create", "malloc");
+	proc = (CSCM_PROC_COMP *)obj->value;
 
 
 	proc->n_params = 0;
 	proc->params = NULL;
+	proc->frame_size = 0;
 	proc->body = NULL;
 	proc->env = NULL;
 
-	obj->value = proc;
-
 
 	return obj;
 }
@@ -140,7 +133,9 @@ CSCM_OBJECT *cscm_proc_comp_create()
 
 void cscm_proc_comp_set(CSCM_OBJECT *proc_obj,	\
 		int flag_dtn,			\
+		int flag_stacked,		\
 		size_t n_params, char **params,	\
+		size_t frame_size,		\
 		CSCM_EF *body,			\
 		CSCM_OBJECT *env)
 {
@@ -150,7 +145,7 @@ void cscm_proc_comp_set(CSCM_OBJECT *proc_obj,	\
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_set", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_set", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -174,10 +169,13 @@ void cscm_proc_comp_set(CSCM_OBJECT *proc_obj,	\
 
 
 	proc->flag_dtn = flag_dtn;
+	proc->flag_stacked = flag_stacked;
 
 	proc->n_params = n_params;
 	proc->params = params;
 
+	proc->frame_size = frame_size;
+
 	proc->body = body;
 
 	proc->env = env;
@@ -195,7 +193,7 @@ size_t cscm_proc_comp_get_flag_dtn(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_get_flag_dtn", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_get_flag_dtn", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -210,6 +208,29 @@ size_t cscm_proc_comp_get_flag_dtn(CSCM_OBJECT *proc_obj)
 }
 
 
+int cscm_proc_comp_get_flag_stacked(CSCM_OBJECT *proc_obj)
+{
+	CSCM_PROC_COMP *proc;
+
+
+	if (proc_obj == NULL)
+		cscm_error_report("cscm_proc_comp_get_flag_stacked", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
+		cscm_error_report("cscm_proc_comp_get_flag_stacked", \
+				CSCM_ERROR_OBJECT_TYPE);
+	else if (proc_obj->value == NULL)
+		cscm_error_report("cscm_proc_comp_get_flag_stacked", \
+				CSCM_ERROR_EMPTY_OBJECT);
+
+
+	proc = (CSCM_PROC_COMP *)proc_obj->value;
+
+
+	return proc->flag_stacked;
+}
+
+
 size_t cscm_proc_comp_get_n_params(CSCM_OBJECT *proc_obj)
 {
 	CSCM_PROC_COMP *proc;
@@ -218,7 +239,7 @@ size_t cscm_proc_comp_get_n_params(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_get_n_params", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_get_n_params", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -241,7 +262,7 @@ char **cscm_proc_comp_get_params(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_get_params", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_get_params", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -256,6 +277,29 @@ char **cscm_proc_comp_get_params(CSCM_OBJECT *proc_obj)
 }
 
 
+size_t cscm_proc_comp_get_frame_size(CSCM_OBJECT *proc_obj)
+{
+	CSCM_PROC_COMP *proc;
+
+
+	if (proc_obj == NULL)
+		cscm_error_report("cscm_proc_comp_get_frame_size", \
+				CSCM_ERROR_NULL_PTR);
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
+		cscm_error_report("cscm_proc_comp_get_frame_size", \
+				CSCM_ERROR_OBJECT_TYPE);
+	else if (proc_obj->value == NULL)
+		cscm_error_report("cscm_proc_comp_get_frame_size", \
+				CSCM_ERROR_EMPTY_OBJECT);
+
+
+	proc = (CSCM_PROC_COMP *)proc_obj->value;
+
+
+	return proc->frame_size;
+}
+
+
 CSCM_EF *cscm_proc_comp_get_body(CSCM_OBJECT *proc_obj)
 {
 	CSCM_PROC_COMP *proc;
@@ -264,7 +308,7 @@ CSCM_EF *cscm_proc_comp_get_body(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_get_body", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_get_body", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -287,7 +331,7 @@ CSCM_OBJECT *cscm_proc_comp_get_env(CSCM_OBJECT *proc_obj)
 	if (proc_obj == NULL)
 		cscm_error_report("cscm_proc_comp_get_env", \
 				CSCM_ERROR_NULL_PTR);
-	else if (proc_obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(proc_obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_get_env", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (proc_obj->value == NULL)
@@ -311,9 +355,9 @@ void cscm_proc_print(CSCM_OBJECT *obj, FILE *stream)
 				CSCM_ERROR_NULL_PTR);
 
 
-	if (obj->type == CSCM_OBJECT_TYPE_PROC_PRIM)
+	if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_PROC_PRIM)
 		printf("<pproc at %p>", obj);
-	else if (obj->type == CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_PROC_COMP)
 		printf("<cproc at %p>", obj);
 	else
 		cscm_error_report("cscm_proc_print", \
@@ -328,14 +372,12 @@ void cscm_proc_prim_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_proc_prim_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_PROC_PRIM)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_PROC_PRIM)
 		cscm_error_report("cscm_proc_prim_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
 
-	free(obj->value);
-
-	free(obj);
+	cscm_object_destroy_inline(obj, sizeof(CSCM_PROC_PRIM));
 }
 
 
@@ -349,7 +391,7 @@ void cscm_proc_comp_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_proc_comp_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_PROC_COMP)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_PROC_COMP)
 		cscm_error_report("cscm_proc_comp_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -366,7 +408,5 @@ void cscm_proc_comp_free(CSCM_OBJECT *obj)
 	cscm_gc_dec(proc->env);
 	cscm_gc_free(proc->env);
 
-	free(proc);
-
-	free(obj);
+	cscm_object_destroy_inline(obj, sizeof(CSCM_PROC_COMP));
 }
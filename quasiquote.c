@@ -27,6 +27,8 @@
 #include "num.h"
 #include "str.h"
 #include "pair.h"
+#include "gc.h"
+#include "quote.h"
 #include "quasiquote.h"
 
 
@@ -77,12 +79,15 @@ CSCM_QUASIQUOTE_EF_STATE *_cscm_quasiquote_ef_state_create()
 
 	state->n_efs = 0;
 	state->efs = NULL;
+	state->tail = CSCM_NIL;
 
 
 	return state;
 }
 
 
+/*	Only the spine of a list up to its last unquoted element is
+ * built by each evaluation, on which the constant tail is shared. */
 CSCM_OBJECT *_cscm_quasiquote_ef(void *state, CSCM_OBJECT *env)
 {
 	int i;
@@ -90,25 +95,30 @@ CSCM_OBJECT *_cscm_quasiquote_ef(void *state, CSCM_OBJECT *env)
 	CSCM_QUASIQUOTE_EF_STATE *s;
 
 	CSCM_OBJECT **objs;
-	CSCM_OBJECT *ret;
+	CSCM_OBJECT *pair, *ret;
 
 
 	s = (CSCM_QUASIQUOTE_EF_STATE *)state;
 
 
-	if (s->n_efs == 0) {
-		ret = CSCM_NIL;
-	} else {
-		objs = cscm_object_ptrs_create(s->n_efs);
+	/* unquoted expressions may apply compound procedures */
+	objs = cscm_object_ptrs_push(s->n_efs);
 
-		for (i = 0; i < s->n_efs; i++)
-			objs[i] = cscm_ef_exec(s->efs[i], env);
+	for (i = 0; i < s->n_efs; i++)
+		objs[i] = cscm_ef_exec(s->efs[i], env);
 
-		ret = cscm_list_create(s->n_efs, objs);
 
-		free(objs);
+	ret = s->tail;
+
+	for (i = s->n_efs - 1; i >= 0; i--) {
+		pair = cscm_pair_create();
+		cscm_pair_set(pair, objs[i], ret);
+
+		ret = pair;
 	}
 
+	cscm_object_ptrs_pop(objs);
+
 
 	return ret;
 }
@@ -139,58 +149,86 @@ int _cscm_quasiquote_is_unquote(CSCM_AST_NODE *exp)
 }
 
 
+int _cscm_quasiquote_is_constant(CSCM_AST_NODE *node)
+{
+	int i;
+
+
+	if (cscm_ast_is_symbol(node))
+		return 1;
+	else if (_cscm_quasiquote_is_unquote(node))
+		return 0;
+
+
+	for (i = 0; i < node->n_childs; i++)
+		if (!_cscm_quasiquote_is_constant(cscm_ast_exp_index(node, i)))
+			return 0;
+
+	return 1;
+}
+
+
 CSCM_EF *_do_cscm_analyze_quasiquote(CSCM_AST_NODE *node)
 {
 	int i;
 	CSCM_AST_NODE *clause, *child;
 
+	CSCM_OBJECT *pair;
+
 	CSCM_QUASIQUOTE_EF_STATE *state;
 
 
-	if (node == NULL) {
+	if (node == NULL)
 		cscm_error_report("_do_cscm_analyze_quasiquote", \
 				CSCM_ERROR_NULL_PTR);
-	} else if (cscm_ast_is_symbol(node)) {
-		if (cscm_is_num_long(node))
-			return cscm_analyze_num_long(node);
-		else if (cscm_is_num_double(node))
-			return cscm_analyze_num_double(node);
-		else if (cscm_is_string(node))
-			return cscm_analyze_string(node);
-		else
-			return cscm_analyze_symbol(node);
-	} else if (cscm_ast_is_exp(node)) {
-		if (_cscm_quasiquote_is_unquote(node)) {
-			clause = cscm_ast_exp_index(node, 1);
-
-			return cscm_analyze(clause);
-		} else {
-			state = _cscm_quasiquote_ef_state_create();
-
-			state->n_efs = node->n_childs;
-
-			if (node->n_childs == 0) {
-				state->efs = NULL;
-			} else {
-				state->efs = cscm_ef_ptrs_create(node->n_childs);
-
-				for (i = 0; i < node->n_childs; i++) {
-					child = cscm_ast_exp_index(node, i);
-					state->efs[i] = \
-					    _do_cscm_analyze_quasiquote(child);
-				}
-			}
-
-
-			return cscm_ef_construct(CSCM_EF_TYPE_QUASIQUOTE, \
-						state,                    \
-						NULL,                     \
-						_cscm_quasiquote_ef);
-		}
-	} else {
+	else if (!cscm_ast_is_symbol(node) && !cscm_ast_is_exp(node))
 		cscm_error_report("_do_cscm_analyze_quasiquote", \
 				CSCM_ERROR_AST_NODE_TYPE);
+
+
+	if (_cscm_quasiquote_is_constant(node))
+		return cscm_analyze_quote_datum(node);
+
+
+	if (_cscm_quasiquote_is_unquote(node)) {
+		clause = cscm_ast_exp_index(node, 1);
+
+		return cscm_analyze(clause);
+	}
+
+
+	state = _cscm_quasiquote_ef_state_create();
+
+	/* elements behind the last unquoted one are a constant tail */
+	state->n_efs = node->n_childs;
+	while (_cscm_quasiquote_is_constant(				\
+			cscm_ast_exp_index(node, state->n_efs - 1)))
+		state->n_efs--;
+
+	for (i = node->n_childs - 1; i >= state->n_efs; i--) {
+		child = cscm_ast_exp_index(node, i);
+
+		pair = cscm_pair_create();
+		cscm_pair_set(pair, cscm_quote_datum(child), state->tail);
+
+		state->tail = pair;
 	}
+
+	cscm_gc_inc(state->tail); // kept by the execution function
+
+
+	state->efs = cscm_ef_ptrs_create(state->n_efs);
+
+	for (i = 0; i < state->n_efs; i++) {
+		child = cscm_ast_exp_index(node, i);
+		state->efs[i] = _do_cscm_analyze_quasiquote(child);
+	}
+
+
+	return cscm_ef_construct(CSCM_EF_TYPE_QUASIQUOTE,	\
+				state,				\
+				NULL,				\
+				_cscm_quasiquote_ef);
 }
 
 
@@ -230,6 +268,9 @@ void cscm_quasiquote_ef_free(CSCM_EF *ef)
 	if (state->efs)
 		free(state->efs);
 
+	cscm_gc_dec(state->tail);
+	cscm_gc_free(state->tail);
+
 	free(state);
 
 
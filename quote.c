@@ -26,6 +26,8 @@
 #include "num.h"
 #include "str.h"
 #include "pair.h"
+#include "text.h"
+#include "gc.h"
 #include "quote.h"
 
 
@@ -63,99 +65,86 @@ int cscm_is_quote(CSCM_AST_NODE *exp)
 
 
 
-CSCM_QUOTE_EF_STATE *_cscm_quote_ef_state_create()
-{
-	CSCM_QUOTE_EF_STATE *state;
-
-
-	state = malloc(sizeof(CSCM_QUOTE_EF_STATE));
-	if (state == NULL)
-		cscm_libc_fail("cscm_quote_ef_state_create", "malloc");
-
-
-	state->n_efs = 0;
-	state->efs = NULL;
-
-
-	return state;
-}
-
-
-CSCM_OBJECT *_cscm_quote_ef(void *state, CSCM_OBJECT *env)
+/*	Quoted data are built once at analysis time, and every
+ * evaluation of the quotation returns the same object, which is kept
+ * by its execution function until the function is freed. As in other
+ * Scheme implementations, they should never be modified by programs. */
+CSCM_OBJECT *cscm_quote_datum(CSCM_AST_NODE *node)
 {
 	int i;
-
-	CSCM_QUOTE_EF_STATE *s;
+	char *text;
+	CSCM_AST_NODE *child;
 
 	CSCM_OBJECT **objs;
 	CSCM_OBJECT *ret;
 
 
-	s = (CSCM_QUOTE_EF_STATE *)state;
+	if (node == NULL) {
+		cscm_error_report("cscm_quote_datum", \
+				CSCM_ERROR_NULL_PTR);
+	} else if (cscm_ast_is_symbol(node)) {
+		if (cscm_is_num_long(node)) {
+			ret = cscm_num_long_create(atol(node->text));
+		} else if (cscm_is_num_double(node)) {
+			ret = cscm_num_double_create();
+			cscm_num_double_set(ret, atof(node->text));
+		} else if (cscm_is_string(node)) {
+			ret = cscm_string_create();
+
+			text = cscm_text_cpy_strip_dquotes(node->text);
+			cscm_string_set(ret, text);
+			free(text);
+		} else {
+			text = cscm_text_cpy_lowercase(node->text);
+			ret = cscm_symbol_intern_simple(text);
+		}
+	} else if (cscm_ast_is_exp(node)) {
+		if (node->n_childs == 0)
+			return CSCM_NIL;
 
 
-	if (s->n_efs == 0) {
-		ret = CSCM_NIL;
-	} else {
-		objs = cscm_object_ptrs_create(s->n_efs);
+		objs = cscm_object_ptrs_push(node->n_childs);
 
-		for (i = 0; i < s->n_efs; i++)
-			objs[i] = cscm_ef_exec(s->efs[i], env);
+		for (i = 0; i < node->n_childs; i++) {
+			child = cscm_ast_exp_index(node, i);
+			objs[i] = cscm_quote_datum(child);
+		}
 
-		ret = cscm_list_create(s->n_efs, objs);
+		ret = cscm_list_create(node->n_childs, objs);
 
-		free(objs);
+		cscm_object_ptrs_pop(objs);
+	} else {
+		cscm_error_report("cscm_quote_datum", \
+				CSCM_ERROR_AST_NODE_TYPE);
 	}
 
+
 	return ret;
 }
 
 
-CSCM_EF *_do_cscm_analyze_quote(CSCM_AST_NODE *node)
-{
-	int i;
-	CSCM_AST_NODE *child;
 
-	CSCM_QUOTE_EF_STATE *state;
 
+CSCM_OBJECT *_cscm_quote_ef(void *state, CSCM_OBJECT *env)
+{
+	return (CSCM_OBJECT *)state;
+}
 
-	if (node == NULL) {
-		cscm_error_report("_do_cscm_analyze_quote", \
-				CSCM_ERROR_NULL_PTR);
-	} else if (cscm_ast_is_symbol(node)) {
-		if (cscm_is_num_long(node))
-			return cscm_analyze_num_long(node);
-		else if (cscm_is_num_double(node))
-			return cscm_analyze_num_double(node);
-		else if (cscm_is_string(node))
-			return cscm_analyze_string(node);
-		else
-			return cscm_analyze_symbol(node);
-	} else if (cscm_ast_is_exp(node)) {
-		state = _cscm_quote_ef_state_create();
 
-		state->n_efs = node->n_childs;
+CSCM_EF *cscm_analyze_quote_datum(CSCM_AST_NODE *datum)
+{
+	CSCM_OBJECT *obj;
 
-		if (node->n_childs == 0) {
-			state->efs = NULL;
-		} else {
-			state->efs = cscm_ef_ptrs_create(node->n_childs);
 
-			for (i = 0; i < node->n_childs; i++) {
-				child = cscm_ast_exp_index(node, i);
-				state->efs[i] = _do_cscm_analyze_quote(child);
-			}
-		}
+	obj = cscm_quote_datum(datum);
 
+	cscm_gc_inc(obj); // kept by the execution function
 
-		return cscm_ef_construct(CSCM_EF_TYPE_QUOTE,	\
-					state,			\
-					NULL,			\
-					_cscm_quote_ef);
-	} else {
-		cscm_error_report("_do_cscm_analyze_quote", \
-				CSCM_ERROR_AST_NODE_TYPE);
-	}
+
+	return cscm_ef_construct(CSCM_EF_TYPE_QUOTE,	\
+				obj,			\
+				NULL,			\
+				_cscm_quote_ef);
 }
 
 
@@ -165,7 +154,7 @@ CSCM_EF *cscm_analyze_quote(CSCM_AST_NODE *exp)
 
 
 	clause = cscm_ast_exp_index(exp, 1);
-	return _do_cscm_analyze_quote(clause);
+	return cscm_analyze_quote_datum(clause);
 }
 
 
@@ -173,9 +162,7 @@ CSCM_EF *cscm_analyze_quote(CSCM_AST_NODE *exp)
 
 void cscm_quote_ef_free(CSCM_EF *ef)
 {
-	int i;
-
-	CSCM_QUOTE_EF_STATE *state;
+	CSCM_OBJECT *obj;
 
 
 	if (ef == NULL)
@@ -186,16 +173,10 @@ void cscm_quote_ef_free(CSCM_EF *ef)
 				CSCM_ERROR_EF_TYPE);
 
 
-	state = (CSCM_QUOTE_EF_STATE *)ef->state;
-
-
-	for (i = 0; i < state->n_efs; i++)
-		cscm_ef_free_tree(state->efs[i]);
-
-	if (state->efs)
-		free(state->efs);
+	obj = (CSCM_OBJECT *)ef->state;
 
-	free(state);
+	cscm_gc_dec(obj);
+	cscm_gc_free(obj);
 
 
 	free(ef);
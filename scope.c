@@ -0,0 +1,974 @@
+/* scope.c -- compile-time scope
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "ast.h"
+#include "symbol.h"
+#include "scope.h"
+
+
+
+
+/*	The innermost scope of the lambda expression being analyzed.
+ * NULL means expressions are analyzed in the global environment. */
+CSCM_SCOPE *_cscm_scope_current = NULL;
+
+
+/*	The number of lambda expressions analyzed so far which create
+ * procedure objects when they are evaluated. A body which creates no
+ * procedure object can not capture the environment where it runs. */
+size_t _cscm_scope_n_closures = 0;
+
+
+
+
+CSCM_SCOPE *_cscm_scope_create()
+{
+	CSCM_SCOPE *scope;
+
+
+	scope = malloc(sizeof(CSCM_SCOPE));
+	if (scope == NULL)
+		cscm_libc_fail("_cscm_scope_create", "malloc");
+
+
+	scope->flag_dynamic = 0;
+
+	scope->n_vars = 0;
+	scope->size = 0;
+	scope->vars = NULL;
+	scope->flags = NULL;
+
+	scope->n_params = 0;
+
+	scope->n_defs = 0;
+	scope->defs_size = 0;
+	scope->defs = NULL;
+
+	scope->n_procs = 0;
+	scope->procs_size = 0;
+	scope->procs = NULL;
+
+	scope->flag_closure = 0;
+	scope->depths = NULL;
+	scope->slots = NULL;
+	scope->enclosing = NULL;
+
+	scope->outer = NULL;
+
+
+	return scope;
+}
+
+
+void _cscm_scope_free(CSCM_SCOPE *scope)
+{
+	if (scope->vars)
+		free(scope->vars);
+
+	if (scope->flags)
+		free(scope->flags);
+
+	if (scope->defs)
+		free(scope->defs);
+
+	if (scope->procs)
+		free(scope->procs);
+
+	if (scope->depths)
+		free(scope->depths);
+
+	if (scope->slots)
+		free(scope->slots);
+
+	free(scope);
+}
+
+
+
+
+#define _CSCM_SCOPE_IS_CELL(scope, i)					\
+	((scope)->flags[i] & CSCM_SCOPE_VAR_CAPTURED			\
+	&& ((scope)->flags[i] & CSCM_SCOPE_VAR_ASSIGNED			\
+		|| (i) >= (scope)->n_params))
+
+
+
+
+void _cscm_scope_add_var(CSCM_SCOPE *scope, char *var)
+{
+	int i;
+
+
+	for (i = 0; i < scope->n_vars; i++)
+		if (var == scope->vars[i])
+			return;
+
+
+	if (scope->n_vars >= scope->size) {
+		scope->size = scope->size ? 2 * scope->size : 8;
+
+		scope->vars = realloc(scope->vars, \
+				scope->size * sizeof(char *));
+		if (scope->vars == NULL)
+			cscm_libc_fail("_cscm_scope_add_var", "realloc");
+
+		scope->flags = realloc(scope->flags, \
+				scope->size * sizeof(int));
+		if (scope->flags == NULL)
+			cscm_libc_fail("_cscm_scope_add_var", "realloc");
+
+		if (scope->flag_closure) {
+			scope->depths = realloc(scope->depths, \
+					scope->size * sizeof(size_t));
+			if (scope->depths == NULL)
+				cscm_libc_fail("_cscm_scope_add_var", \
+						"realloc");
+
+			scope->slots = realloc(scope->slots, \
+					scope->size * sizeof(size_t));
+			if (scope->slots == NULL)
+				cscm_libc_fail("_cscm_scope_add_var", \
+						"realloc");
+		}
+	}
+
+
+	scope->flags[scope->n_vars] = 0;
+	scope->vars[scope->n_vars++] = var;
+}
+
+
+/* var is captured by the closure scope from (depth, slot) */
+void _cscm_scope_add_capture(CSCM_SCOPE *scope, \
+		char *var, size_t depth, size_t slot)
+{
+	_cscm_scope_add_var(scope, var);
+
+	scope->depths[scope->n_vars - 1] = depth;
+	scope->slots[scope->n_vars - 1] = slot;
+}
+
+
+/* var is used as a value, so it must be bound to a procedure object */
+void _cscm_scope_escape(CSCM_SCOPE *scope, char *var)
+{
+	int i;
+
+
+	for (i = 0; i < scope->n_procs; i++)
+		if (var == scope->procs[i].var)
+			scope->procs[i].lambda_ef_ptr = NULL;
+}
+
+
+
+
+void cscm_scope_enter(size_t n_params, char **params)
+{
+	int i;
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_create();
+
+	for (i = 0; i < n_params; i++)
+		_cscm_scope_add_var(scope, params[i]);
+
+	scope->n_params = scope->n_vars;
+
+
+	scope->outer = _cscm_scope_current;
+	_cscm_scope_current = scope;
+}
+
+
+void cscm_scope_leave()
+{
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_leave", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	_cscm_scope_current = scope->outer;
+
+	_cscm_scope_free(scope);
+}
+
+
+
+
+size_t cscm_scope_get_n_vars()
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_get_n_vars", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	return _cscm_scope_current->n_vars;
+}
+
+
+int cscm_scope_is_dynamic()
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_is_dynamic", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	return _cscm_scope_current->flag_dynamic;
+}
+
+
+void cscm_scope_set_dynamic()
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_set_dynamic", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	_cscm_scope_current->flag_dynamic = 1;
+}
+
+
+
+
+/*	exp is a definition at the top level of the body. It must be
+ * added before the body is analyzed. */
+void cscm_scope_add_definition(CSCM_AST_NODE *exp)
+{
+	int i;
+	CSCM_SCOPE *scope;
+	CSCM_AST_NODE *var;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_add_definition", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	var = cscm_ast_exp_index(exp, 1);
+	if (cscm_ast_is_exp(var)) // (define (proc params) body)
+		var = cscm_ast_exp_index(var, 0);
+
+	_cscm_scope_add_var(scope, cscm_symbol_intern_text(var->text));
+	_cscm_scope_escape(scope, cscm_symbol_intern_text(var->text));
+
+	/* a parameter bound again is assigned after the frame is created */
+	for (i = 0; i < scope->n_params; i++)
+		if (scope->vars[i] == cscm_symbol_intern_text(var->text))
+			scope->flags[i] |= CSCM_SCOPE_VAR_ASSIGNED;
+
+
+	if (scope->n_defs >= scope->defs_size) {
+		scope->defs_size = scope->defs_size ? 2 * scope->defs_size : 8;
+
+		scope->defs = realloc(scope->defs, \
+				scope->defs_size * sizeof(CSCM_AST_NODE *));
+		if (scope->defs == NULL)
+			cscm_libc_fail("cscm_scope_add_definition", \
+					"realloc");
+	}
+
+	scope->defs[scope->n_defs++] = exp;
+}
+
+
+/*	Called when analyzing a definition. The current scope will
+ * be marked dynamic when exp has not been added before. */
+void cscm_scope_check_definition(CSCM_AST_NODE *exp)
+{
+	int i;
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL) // global definition
+		return;
+
+
+	for (i = 0; i < scope->n_defs; i++)
+		if (scope->defs[i] == exp)
+			return;
+
+
+	cscm_scope_set_dynamic();
+}
+
+
+
+
+/*	The scans below look for definitions which are not at the top
+ * level of a body before the body is analyzed, so that a dynamic scope
+ * is known at once and the body is only analyzed once. They only look
+ * at the syntax, and may find a definition which will not be analyzed
+ * in the scope, e.g. one in a quasiquote template, which only costs
+ * the lexical addresses of the scope. Bodies of the expressions
+ * creating scopes of their own are skipped unless flag_deep is set,
+ * while their inits are always scanned even when they are analyzed in
+ * the new scope. */
+int _cscm_scope_is_form(CSCM_AST_NODE *exp, char *keyword)
+{
+	CSCM_AST_NODE *head;
+
+
+	if (!cscm_ast_is_exp(exp) || cscm_ast_is_exp_empty(exp))
+		return 0;
+
+
+	head = cscm_ast_exp_index(exp, 0);
+
+	return cscm_ast_is_symbol(head)				\
+		&& cscm_ast_symbol_text_equal(head, keyword);
+}
+
+
+/* any definition in node, as if every list were an expression */
+int _cscm_scope_has_definition(CSCM_AST_NODE *node)
+{
+	int i;
+
+
+	if (!cscm_ast_is_exp(node))
+		return 0;
+	else if (_cscm_scope_is_form(node, "define"))
+		return 1;
+
+
+	for (i = 0; i < node->n_childs; i++)
+		if (_cscm_scope_has_definition(cscm_ast_exp_index(node, i)))
+			return 1;
+
+	return 0;
+}
+
+
+int _cscm_scope_scan_exp(CSCM_AST_NODE *exp, int flag_deep);
+
+
+/* expressions of exp starting at index first */
+int _cscm_scope_scan_seq(CSCM_AST_NODE *exp, size_t first, int flag_deep)
+{
+	int i;
+
+
+	if (!cscm_ast_is_exp(exp))
+		return 0;
+
+
+	for (i = first; i < exp->n_childs; i++)
+		if (_cscm_scope_scan_exp(cscm_ast_exp_index(exp, i), flag_deep))
+			return 1;
+
+	return 0;
+}
+
+
+/*	Inits of let, letrec and do bindings, and steps of do bindings
+ * as well when flag_deep is set. */
+int _cscm_scope_scan_bindings(CSCM_AST_NODE *bindings, int flag_deep)
+{
+	int i;
+	CSCM_AST_NODE *binding, *init;
+
+
+	if (!cscm_ast_is_exp(bindings))
+		return 0;
+
+
+	for (i = 0; i < bindings->n_childs; i++) {
+		binding = cscm_ast_exp_index(bindings, i);
+		if (!cscm_ast_is_exp(binding) || binding->n_childs < 2)
+			continue;
+
+		init = cscm_ast_exp_index(binding, 1);
+		if (_cscm_scope_scan_exp(init, flag_deep))
+			return 1;
+		else if (flag_deep && _cscm_scope_scan_seq(binding, 2, 1))
+			return 1;
+	}
+
+	return 0;
+}
+
+
+/*	Definitions at the top level of the body of exp, which starts
+ * at index first, can be found by cscm_scope_add_definition(). */
+int _cscm_scope_scan_body(CSCM_AST_NODE *exp, size_t first, int flag_deep)
+{
+	int i;
+	CSCM_AST_NODE *clause, *var;
+
+
+	for (i = first; i < exp->n_childs; i++) {
+		clause = cscm_ast_exp_index(exp, i);
+
+		if (!_cscm_scope_is_form(clause, "define")) {
+			if (_cscm_scope_scan_exp(clause, flag_deep))
+				return 1;
+			else
+				continue;
+		} else if (clause->n_childs < 3) {
+			continue;
+		}
+
+		var = cscm_ast_exp_index(clause, 1);
+		if (cscm_ast_is_symbol(var)				\
+			&& _cscm_scope_scan_exp(cscm_ast_exp_index(clause, 2), \
+						flag_deep))
+			return 1;
+		else if (cscm_ast_is_exp(var) && flag_deep		\
+			&& _cscm_scope_scan_body(clause, 2, 1))
+			return 1;
+	}
+
+	return 0;
+}
+
+
+/* exp is analyzed in the current scope, and is not at the top level */
+int _cscm_scope_scan_exp(CSCM_AST_NODE *exp, int flag_deep)
+{
+	int i, first;
+	CSCM_AST_NODE *head, *bindings, *clause;
+
+
+	if (!cscm_ast_is_exp(exp) || cscm_ast_is_exp_empty(exp))
+		return 0;
+
+
+	head = cscm_ast_exp_index(exp, 0);
+	if (!cscm_ast_is_symbol(head))
+		return _cscm_scope_scan_seq(exp, 0, flag_deep);
+
+
+	if (cscm_ast_symbol_text_equal(head, "define")) {
+		return 1;
+	} else if (cscm_ast_symbol_text_equal(head, "quote")) {
+		return 0;
+	} else if (cscm_ast_symbol_text_equal(head, "quasiquote")) {
+		return _cscm_scope_has_definition(exp);
+	} else if (cscm_ast_symbol_text_equal(head, "lambda")) {
+		return flag_deep && _cscm_scope_scan_body(exp, 2, 1);
+	} else if (cscm_ast_symbol_text_equal(head, "letrec")) {
+		if (!flag_deep || exp->n_childs < 3)
+			return 0;
+
+		bindings = cscm_ast_exp_index(exp, 1);
+
+		return _cscm_scope_scan_bindings(bindings, 1)		\
+			|| _cscm_scope_scan_body(exp, 2, 1);
+	} else if (cscm_ast_symbol_text_equal(head, "let")) {
+		if (exp->n_childs < 3)
+			return 0;
+
+		first = 2;
+		bindings = cscm_ast_exp_index(exp, 1);
+		if (cscm_ast_is_symbol(bindings)) { // named let
+			first = 3;
+			bindings = cscm_ast_exp_index(exp, 2);
+		}
+
+		if (_cscm_scope_scan_bindings(bindings, flag_deep))
+			return 1;
+
+		return flag_deep && _cscm_scope_scan_body(exp, first, 1);
+	} else if (cscm_ast_symbol_text_equal(head, "do")) {
+		if (exp->n_childs < 3)
+			return 0;
+
+		bindings = cscm_ast_exp_index(exp, 1);
+		if (_cscm_scope_scan_bindings(bindings, flag_deep))
+			return 1;
+
+		/* the test clause and commands are inside the loop */
+		clause = cscm_ast_exp_index(exp, 2);
+
+		return flag_deep && (_cscm_scope_scan_seq(clause, 0, 1)	\
+				|| _cscm_scope_scan_seq(exp, 3, 1));
+	} else if (cscm_ast_symbol_text_equal(head, "cond")) {
+		for (i = 1; i < exp->n_childs; i++)
+			if (_cscm_scope_scan_seq(cscm_ast_exp_index(exp, i), \
+						0, flag_deep))
+				return 1;
+
+		return 0;
+	}
+
+
+	return _cscm_scope_scan_seq(exp, 1, flag_deep);
+}
+
+
+/*	Mark the current scope dynamic when the body of exp, which
+ * starts at index first, has a definition which is not at its top
+ * level. */
+void cscm_scope_scan_body(CSCM_AST_NODE *exp, size_t first)
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_scan_body", \
+				CSCM_ERROR_SCOPE_EMPTY);
+	else if (exp == NULL)
+		cscm_error_report("cscm_scope_scan_body", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (_cscm_scope_scan_body(exp, first, 0))
+		cscm_scope_set_dynamic();
+}
+
+
+/*	Like cscm_scope_scan_body(), but exp is analyzed in the
+ * current scope without being a part of its body, e.g. an init of
+ * letrec. */
+void cscm_scope_scan_exp(CSCM_AST_NODE *exp)
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_scan_exp", \
+				CSCM_ERROR_SCOPE_EMPTY);
+	else if (exp == NULL)
+		cscm_error_report("cscm_scope_scan_exp", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (_cscm_scope_scan_exp(exp, 0))
+		cscm_scope_set_dynamic();
+}
+
+
+
+
+/*	Return CSCM_SCOPE_ADDR_LOCAL and store the lexical address of
+ * var when var can be found in a static scope, and no dynamic scope
+ * is between them. Otherwise, return CSCM_SCOPE_ADDR_GLOBAL when
+ * there is no dynamic scope at all, or CSCM_SCOPE_ADDR_DYNAMIC.
+ *	A variable not found in a closure scope is resolved in the
+ * scopes enclosing it, and captured by it when it is local there.
+ * mode holds the CSCM_SCOPE_VAR_* flags to be set on var. */
+int _cscm_scope_resolve(CSCM_SCOPE *scope, char *var,		\
+			size_t *depth_ptr, size_t *slot_ptr,	\
+			int mode)
+{
+	int i, addr;
+	size_t depth, enclosing_depth, enclosing_slot;
+
+
+	for (depth = 0; scope; scope = scope->outer, depth++) {
+		if (scope->flag_dynamic)
+			break;
+
+		for (i = 0; i < scope->n_vars; i++) {
+			if (var == scope->vars[i]) {
+				_cscm_scope_escape(scope, var);
+				scope->flags[i] |= mode;
+
+				/* the captured copy is the same cell */
+				if (scope->flag_closure			\
+					&& mode & CSCM_SCOPE_VAR_ASSIGNED)
+					_cscm_scope_resolve(scope->enclosing, \
+							var,		      \
+							&enclosing_depth,     \
+							&enclosing_slot,      \
+							mode);
+
+				*depth_ptr = depth;
+				*slot_ptr = i;
+
+				return CSCM_SCOPE_ADDR_LOCAL;
+			}
+		}
+
+		if (scope->flag_closure) {
+			addr = _cscm_scope_resolve(scope->enclosing,	\
+						var,			\
+						&enclosing_depth,	\
+						&enclosing_slot,	\
+						mode | CSCM_SCOPE_VAR_CAPTURED);
+			if (addr != CSCM_SCOPE_ADDR_LOCAL)
+				return addr;
+
+			_cscm_scope_add_capture(scope,			\
+						var,			\
+						enclosing_depth,	\
+						enclosing_slot);
+			scope->flags[scope->n_vars - 1] = mode;
+
+			*depth_ptr = depth;
+			*slot_ptr = scope->n_vars - 1;
+
+			return CSCM_SCOPE_ADDR_LOCAL;
+		}
+	}
+
+	if (scope == NULL)
+		return CSCM_SCOPE_ADDR_GLOBAL;
+
+
+	/*	var will be searched by its name, and any outer binding of
+	 * it may be found. */
+	while (scope) {
+		_cscm_scope_escape(scope, var);
+
+		if (scope->flag_closure)
+			scope = scope->enclosing;
+		else
+			scope = scope->outer;
+	}
+
+
+	return CSCM_SCOPE_ADDR_DYNAMIC;
+}
+
+
+int cscm_scope_resolve(char *var, size_t *depth_ptr, size_t *slot_ptr)
+{
+	if (var == NULL || depth_ptr == NULL || slot_ptr == NULL)
+		cscm_error_report("cscm_scope_resolve", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	return _cscm_scope_resolve(_cscm_scope_current,	\
+				var,			\
+				depth_ptr,		\
+				slot_ptr,		\
+				0);
+}
+
+
+/* like cscm_scope_resolve(), but var is the target of an assignment */
+int cscm_scope_resolve_assignment(char *var, \
+		size_t *depth_ptr, size_t *slot_ptr)
+{
+	if (var == NULL || depth_ptr == NULL || slot_ptr == NULL)
+		cscm_error_report("cscm_scope_resolve_assignment", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	return _cscm_scope_resolve(_cscm_scope_current,	\
+				var,			\
+				depth_ptr,		\
+				slot_ptr,		\
+				CSCM_SCOPE_VAR_ASSIGNED);
+}
+
+
+/*	var of the current scope is assigned after the frame is
+ * created, e.g. variables bound by letrec. */
+void cscm_scope_add_assignment(char *var)
+{
+	int i;
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_add_assignment", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	for (i = 0; i < scope->n_vars; i++)
+		if (var == scope->vars[i])
+			scope->flags[i] |= CSCM_SCOPE_VAR_ASSIGNED;
+}
+
+
+
+
+/*	var is bound by letrec in the current scope to the lambda
+ * expression which will be stored in *lambda_ef_ptr. */
+void cscm_scope_add_proc(char *var, CSCM_EF **lambda_ef_ptr)
+{
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_add_proc", \
+				CSCM_ERROR_SCOPE_EMPTY);
+	else if (var == NULL || lambda_ef_ptr == NULL)
+		cscm_error_report("cscm_scope_add_proc", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	if (scope->n_procs >= scope->procs_size) {
+		scope->procs_size = scope->procs_size			\
+					? 2 * scope->procs_size : 8;
+
+		scope->procs = realloc(scope->procs,			\
+				scope->procs_size * sizeof(CSCM_SCOPE_PROC));
+		if (scope->procs == NULL)
+			cscm_libc_fail("cscm_scope_add_proc", "realloc");
+	}
+
+
+	scope->procs[scope->n_procs].var = var;
+	scope->procs[scope->n_procs].lambda_ef_ptr = lambda_ef_ptr;
+	scope->n_procs++;
+}
+
+
+CSCM_EF **_cscm_scope_get_proc(CSCM_SCOPE *scope, char *var)
+{
+	int i;
+
+
+	for (i = 0; i < scope->n_procs; i++)
+		if (var == scope->procs[i].var)
+			return scope->procs[i].lambda_ef_ptr;
+
+	return NULL;
+}
+
+
+/* NULL when var of the current scope has been used as a value */
+CSCM_EF **cscm_scope_get_proc(char *var)
+{
+	if (_cscm_scope_current == NULL)
+		cscm_error_report("cscm_scope_get_proc", \
+				CSCM_ERROR_SCOPE_EMPTY);
+
+
+	return _cscm_scope_get_proc(_cscm_scope_current, var);
+}
+
+
+/*	Like cscm_scope_resolve(), but only succeeds when var is an
+ * operator which can be applied without its procedure object. */
+CSCM_EF **cscm_scope_resolve_proc(char *var, size_t *depth_ptr)
+{
+	int i;
+	size_t depth;
+	CSCM_SCOPE *scope;
+
+
+	if (var == NULL || depth_ptr == NULL)
+		cscm_error_report("cscm_scope_resolve_proc", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	for (scope = _cscm_scope_current, depth = 0;	\
+		scope;					\
+		scope = scope->outer, depth++) {
+		if (scope->flag_dynamic)
+			return NULL;
+
+		for (i = 0; i < scope->n_vars; i++) {
+			if (var == scope->vars[i]) {
+				*depth_ptr = depth;
+
+				return _cscm_scope_get_proc(scope, var);
+			}
+		}
+	}
+
+
+	return NULL;
+}
+
+
+
+
+void cscm_scope_add_closure()
+{
+	_cscm_scope_n_closures++;
+}
+
+
+size_t cscm_scope_get_n_closures()
+{
+	return _cscm_scope_n_closures;
+}
+
+
+/*	Restore the number of closures, in order to forget lambda
+ * expressions which have turned out to create no procedure objects. */
+void cscm_scope_set_n_closures(size_t n)
+{
+	_cscm_scope_n_closures = n;
+}
+
+
+
+
+/*	Enter a closure scope for the lambda expression exp to be
+ * analyzed next, and return 1, or return 0 without entering it when a
+ * dynamic scope encloses exp, or will be found inside it. Nothing in a
+ * flat closure needs to be scanned again. */
+int cscm_scope_enter_closure(CSCM_AST_NODE *exp)
+{
+	int flag_scanned;
+	CSCM_SCOPE *scope;
+
+
+	if (exp == NULL)
+		cscm_error_report("cscm_scope_enter_closure", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	flag_scanned = 0;
+
+	scope = _cscm_scope_current;
+	while (scope) {
+		if (scope->flag_dynamic)
+			return 0;
+
+		if (scope->flag_closure) {
+			flag_scanned = 1;
+			scope = scope->enclosing;
+		} else {
+			scope = scope->outer;
+		}
+	}
+
+	if (!flag_scanned && _cscm_scope_scan_body(exp, 2, 1))
+		return 0;
+
+
+	scope = _cscm_scope_create();
+
+	scope->flag_closure = 1;
+	scope->enclosing = _cscm_scope_current;
+
+	_cscm_scope_current = scope;
+
+
+	return 1;
+}
+
+
+/*	Leave the current closure scope, and return the number of
+ * variables captured by it, whose lexical addresses in the scopes
+ * enclosing it are moved into the arrays stored in the pointers. */
+size_t cscm_scope_leave_closure(char ***vars_ptr, \
+		size_t **depths_ptr, size_t **slots_ptr)
+{
+	size_t n;
+	CSCM_SCOPE *scope;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_leave_closure", \
+				CSCM_ERROR_SCOPE_EMPTY);
+	else if (!scope->flag_closure)
+		cscm_error_report("cscm_scope_leave_closure", \
+				CSCM_ERROR_SCOPE_NO_CLOSURE);
+	else if (vars_ptr == NULL || depths_ptr == NULL || slots_ptr == NULL)
+		cscm_error_report("cscm_scope_leave_closure", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	_cscm_scope_current = scope->enclosing;
+
+
+	n = scope->n_vars;
+
+	*vars_ptr = scope->vars;
+	*depths_ptr = scope->depths;
+	*slots_ptr = scope->slots;
+
+	scope->vars = NULL;
+	scope->depths = NULL;
+	scope->slots = NULL;
+
+	_cscm_scope_free(scope);
+
+
+	return n;
+}
+
+
+
+
+/*	A captured variable must be kept in a cell when it may be
+ * assigned, or bound by a definition, after the closure has copied
+ * it. Return NULL when the current scope needs no cell. */
+CSCM_SCOPE_CELLS *cscm_scope_get_cells()
+{
+	int i, j;
+	CSCM_SCOPE *scope;
+
+	CSCM_SCOPE_CELLS *cells;
+
+
+	scope = _cscm_scope_current;
+	if (scope == NULL)
+		cscm_error_report("cscm_scope_get_cells", \
+				CSCM_ERROR_SCOPE_EMPTY);
+	else if (scope->flag_dynamic) // nothing is captured
+		return NULL;
+
+
+	cells = malloc(sizeof(CSCM_SCOPE_CELLS));
+	if (cells == NULL)
+		cscm_libc_fail("cscm_scope_get_cells", "malloc");
+
+	cells->n_cells = 0;
+	cells->slots = NULL;
+	cells->vars = NULL;
+
+	for (i = 0; i < scope->n_vars; i++)
+		if (_CSCM_SCOPE_IS_CELL(scope, i))
+			cells->n_cells++;
+
+	if (cells->n_cells == 0) {
+		free(cells);
+		return NULL;
+	}
+
+
+	cells->slots = malloc(cells->n_cells * sizeof(size_t));
+	if (cells->slots == NULL)
+		cscm_libc_fail("cscm_scope_get_cells", "malloc");
+
+	for (i = 0, j = 0; i < scope->n_vars; i++)
+		if (_CSCM_SCOPE_IS_CELL(scope, i))
+			cells->slots[j++] = i;
+
+
+	cells->vars = malloc((cells->slots[j - 1] + 1) * sizeof(char *));
+	if (cells->vars == NULL)
+		cscm_libc_fail("cscm_scope_get_cells", "malloc");
+
+	for (i = 0; i <= cells->slots[j - 1]; i++)
+		cells->vars[i] = scope->vars[i];
+
+
+	return cells;
+}
+
+
+void cscm_scope_cells_free(CSCM_SCOPE_CELLS *cells)
+{
+	if (cells == NULL)
+		cscm_error_report("cscm_scope_cells_free", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	free(cells->slots);
+	free(cells->vars);
+
+	free(cells);
+}
@@ -56,7 +56,7 @@ void cscm_string_set(CSCM_OBJECT *string, char *text)
 	if (string == NULL)
 		cscm_error_report("cscm_string_set", \
 				CSCM_ERROR_NULL_PTR);
-	else if (string->type != CSCM_OBJECT_TYPE_STRING)
+	else if (CSCM_OBJECT_GET_TYPE(string) != CSCM_OBJECT_TYPE_STRING)
 		cscm_error_report("cscm_string_set", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (text == NULL)
@@ -86,7 +86,7 @@ char *cscm_string_get(CSCM_OBJECT *string)
 	if (string == NULL)
 		cscm_error_report("cscm_string_get", \
 				CSCM_ERROR_NULL_PTR);
-	else if (string->type != CSCM_OBJECT_TYPE_STRING)
+	else if (CSCM_OBJECT_GET_TYPE(string) != CSCM_OBJECT_TYPE_STRING)
 		cscm_error_report("cscm_string_get", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (string->value == NULL)
@@ -103,7 +103,7 @@ int cscm_string_text_equal(CSCM_OBJECT *string, char* text)
 	if (string == NULL)
 		cscm_error_report("cscm_string_text_equal", \
 				CSCM_ERROR_NULL_PTR);
-	else if (string->type != CSCM_OBJECT_TYPE_STRING)
+	else if (CSCM_OBJECT_GET_TYPE(string) != CSCM_OBJECT_TYPE_STRING)
 		cscm_error_report("cscm_string_text_equal", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -121,7 +121,7 @@ void cscm_string_print(CSCM_OBJECT *obj, FILE *stream)
 				CSCM_ERROR_NULL_PTR);
 
 
-	if (obj->type == CSCM_OBJECT_TYPE_STRING)
+	if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_STRING)
 		fputs((char *)obj->value, stream);
 	else
 		cscm_error_report("cscm_string_print", \
@@ -194,7 +194,7 @@ void cscm_string_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_string_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_STRING)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_STRING)
 		cscm_error_report("cscm_string_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -202,7 +202,7 @@ void cscm_string_free(CSCM_OBJECT *obj)
 	if (obj->value)
 		free(obj->value);
 
-	free(obj);
+	cscm_object_destroy(obj);
 }
 
 
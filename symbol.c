@@ -15,6 +15,7 @@
    You should have received a copy of the GNU General Public License
    along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
 
+#include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -29,74 +30,168 @@
 
 
 
-CSCM_OBJECT *cscm_symbol_create()
+/*	All symbols are interned in this table, so there is only one
+ * symbol object for each name and symbols can be compared by their
+ * addresses. The table is an open-addressing hash table with linear
+ * probing, and it keeps one reference of each symbol, therefore
+ * symbols will never be freed. */
+CSCM_SYMBOL_TABLE_ENTRY *_cscm_symbol_table = NULL;
+
+size_t _cscm_symbol_table_size = 0;
+size_t _cscm_symbol_table_n_symbols = 0;
+
+
+/* FNV-1a */
+size_t _cscm_symbol_hash(char *text)
+{
+	size_t hash;
+
+
+	for (hash = 2166136261u; *text; text++) {
+		hash ^= (unsigned char)*text;
+		hash *= 16777619u;
+	}
+
+
+	return hash;
+}
+
+
+void _cscm_symbol_table_grow()
+{
+	int i;
+	size_t index, mask;
+
+	size_t old_size;
+	CSCM_SYMBOL_TABLE_ENTRY *old_table;
+
+
+	old_size = _cscm_symbol_table_size;
+	old_table = _cscm_symbol_table;
+
+
+	if (old_size == 0)
+		_cscm_symbol_table_size = CSCM_SYMBOL_TABLE_INIT_SIZE;
+	else
+		_cscm_symbol_table_size = 2 * old_size;
+
+	_cscm_symbol_table = calloc(_cscm_symbol_table_size, \
+				sizeof(CSCM_SYMBOL_TABLE_ENTRY));
+	if (_cscm_symbol_table == NULL)
+		cscm_libc_fail("_cscm_symbol_table_grow", "calloc");
+
+
+	mask = _cscm_symbol_table_size - 1;
+
+	for (i = 0; i < old_size; i++) {
+		if (old_table[i].symbol == NULL)
+			continue;
+
+		index = old_table[i].hash & mask;
+		while (_cscm_symbol_table[index].symbol)
+			index = (index + 1) & mask;
+
+		_cscm_symbol_table[index] = old_table[i];
+	}
+
+
+	if (old_table)
+		free(old_table);
+}
+
+
+/*	Return the symbol named text when it exists, otherwise return
+ * NULL and store the index of the empty entry for it. */
+CSCM_OBJECT *_cscm_symbol_table_lookup(char *text, \
+				size_t hash, size_t *index_ptr)
 {
-	CSCM_OBJECT *obj;
+	size_t index, mask;
+	CSCM_SYMBOL_TABLE_ENTRY *entry;
 
 
-	obj = cscm_object_create();
+	mask = _cscm_symbol_table_size - 1;
 
+	for (index = hash & mask; ; index = (index + 1) & mask) {
+		entry = &_cscm_symbol_table[index];
 
-	obj->type = CSCM_OBJECT_TYPE_SYMBOL;
-	obj->value = NULL;
+		if (entry->symbol == NULL)
+			break;
+		else if (entry->hash == hash \
+			&& !strcmp(text, (char *)entry->symbol->value))
+			return entry->symbol;
+	}
 
 
-	return obj;
+	*index_ptr = index;
+	return NULL;
 }
 
 
 
 
-void cscm_symbol_set(CSCM_OBJECT *symbol, char *text)
+/*	Get the only symbol object named text. text is copied when
+ * a new symbol has to be created. */
+CSCM_OBJECT *cscm_symbol_intern(char *text)
 {
-	char *old_text;
+	size_t hash, index;
+	CSCM_OBJECT *symbol;
 
 
-	if (symbol == NULL)
-		cscm_error_report("cscm_symbol_set", CSCM_ERROR_NULL_PTR);
-	else if (symbol->type != CSCM_OBJECT_TYPE_SYMBOL)
-		cscm_error_report("cscm_symbol_set", CSCM_ERROR_OBJECT_TYPE);
-	else if (text == NULL)
-		cscm_error_report("cscm_symbol_set", CSCM_ERROR_NULL_PTR);
+	if (text == NULL)
+		cscm_error_report("cscm_symbol_intern", CSCM_ERROR_NULL_PTR);
+
+
+	/* keep the load factor below 1/2 */
+	if (2 * (_cscm_symbol_table_n_symbols + 1) > _cscm_symbol_table_size)
+		_cscm_symbol_table_grow();
 
 
-	old_text = symbol->value;
+	hash = _cscm_symbol_hash(text);
+
+	symbol = _cscm_symbol_table_lookup(text, hash, &index);
+	if (symbol)
+		return symbol;
+
+
+	symbol = cscm_object_create();
+
+	symbol->type = CSCM_OBJECT_TYPE_SYMBOL;
 	symbol->value = cscm_text_cpy(text);
 
+	cscm_gc_inc(symbol); // referenced by the table
+
+
+	_cscm_symbol_table[index].hash = hash;
+	_cscm_symbol_table[index].symbol = symbol;
 
-	/*	The new text may be a substring of the old text,
-	 * then there will be no new text after we have freed the
-	 * old text.
-	 * 	Therefore, we have to cscm_text_cpy() the new text
-	 * first, and only after that we can safely free the old
-	 * one. */
-	if (old_text)
-		free(old_text);
+	_cscm_symbol_table_n_symbols++;
+
+
+	return symbol;
 }
 
 
+/*	Identifiers are interned as the texts of symbols, so they can
+ * be shared and compared by their addresses as well. */
+char *cscm_symbol_intern_text(char *text)
+{
+	return (char *)cscm_symbol_intern(text)->value;
+}
 
 
-/*	Since we'll free the memory of old text, we should not call
- * this function with string literals and any substrings of the old
- * text as the new text to be set. */
-void cscm_symbol_set_simple(CSCM_OBJECT *symbol, char *text)
+/*	Same as cscm_symbol_intern, but text should be allocated by
+ * malloc, and it will be owned or freed by this function. */
+CSCM_OBJECT *cscm_symbol_intern_simple(char *text)
 {
-	if (symbol == NULL)
-		cscm_error_report("cscm_symbol_set_simple", \
-				CSCM_ERROR_NULL_PTR);
-	else if (symbol->type != CSCM_OBJECT_TYPE_SYMBOL)
-		cscm_error_report("cscm_symbol_set_simple", \
-				CSCM_ERROR_OBJECT_TYPE);
-	else if (text == NULL)
-		cscm_error_report("cscm_symbol_set_simple", \
-				CSCM_ERROR_NULL_PTR);
+	CSCM_OBJECT *symbol;
+
 
+	symbol = cscm_symbol_intern(text);
 
-	if (symbol->value)
-		free(symbol->value);
+	free(text);
 
-	symbol->value = text;
+
+	return symbol;
 }
 
 
@@ -107,7 +202,7 @@ char *cscm_symbol_get(CSCM_OBJECT *symbol)
 	if (symbol == NULL)
 		cscm_error_report("cscm_symbol_get", \
 				CSCM_ERROR_NULL_PTR);
-	else if (symbol->type != CSCM_OBJECT_TYPE_SYMBOL)
+	else if (CSCM_OBJECT_GET_TYPE(symbol) != CSCM_OBJECT_TYPE_SYMBOL)
 		cscm_error_report("cscm_symbol_get", \
 				CSCM_ERROR_OBJECT_TYPE);
 	else if (symbol->value == NULL)
@@ -128,7 +223,7 @@ void cscm_symbol_print(CSCM_OBJECT *obj, FILE *stream)
 				CSCM_ERROR_NULL_PTR);
 
 
-	if (obj->type == CSCM_OBJECT_TYPE_SYMBOL)
+	if (CSCM_OBJECT_GET_TYPE(obj) == CSCM_OBJECT_TYPE_SYMBOL)
 		fputs((char *)obj->value, stream);
 	else
 		cscm_error_report("cscm_symbol_print", \
@@ -154,10 +249,7 @@ CSCM_EF *cscm_analyze_symbol(CSCM_AST_NODE *exp)
 	 * to simplify processes of comparison. */
 	text = cscm_text_cpy_lowercase(exp->text);
 
-
-	symbol = cscm_symbol_create();
-
-	cscm_symbol_set_simple(symbol, text);
+	symbol = cscm_symbol_intern_simple(text);
 
 
 	/*	The execution function only has 1 copy of this
@@ -180,7 +272,7 @@ void cscm_symbol_free(CSCM_OBJECT *obj)
 	if (obj == NULL)
 		cscm_error_report("cscm_symbol_free", \
 				CSCM_ERROR_NULL_PTR);
-	else if (obj->type != CSCM_OBJECT_TYPE_SYMBOL)
+	else if (CSCM_OBJECT_GET_TYPE(obj) != CSCM_OBJECT_TYPE_SYMBOL)
 		cscm_error_report("cscm_symbol_free", \
 				CSCM_ERROR_OBJECT_TYPE);
 
@@ -188,7 +280,7 @@ void cscm_symbol_free(CSCM_OBJECT *obj)
 	if (obj->value)
 		free(obj->value);
 
-	free(obj);
+	cscm_object_destroy(obj);
 }
 
 
@@ -0,0 +1,145 @@
+; test_engines.scm -- a test for the execution engines of cscheme
+
+; Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+;(at your option) any later version.
+
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+;	Both execution engines must print exactly the same output for
+; this program, which can be checked by:
+;
+;	cscheme --engine=ef tests/test_engines.scm > ef.out
+;	cscheme --engine=vm tests/test_engines.scm > vm.out
+;	diff ef.out vm.out
+
+
+
+
+; closures
+(define (make-adder n)
+	(lambda (x) (+ x n)))
+
+(define add5 (make-adder 5))
+
+(printn "closure:" (add5 10) ((make-adder -1) 1))
+
+
+(define (compose f g)
+	(lambda (x) (f (g x))))
+
+(printn "composed closures:" ((compose add5 (make-adder 100)) 0))
+
+
+
+
+; set! on captured variables
+(define (make-counter)
+	(define count 0)
+	(lambda ()
+		(set! count (+ count 1))
+		count))
+
+(define c1 (make-counter))
+(define c2 (make-counter))
+
+(c1)
+(c1)
+(printn "counters:" (c1) (c2))
+
+
+(define (make-account balance)
+	(define (withdraw amount)
+		(if (> amount balance)
+			"insufficient funds"
+			(begin (set! balance (- balance amount))
+			       balance)))
+	(define (deposit amount)
+		(set! balance (+ balance amount))
+		balance)
+	(lambda (m)
+		(if (eq? m 'withdraw) withdraw deposit)))
+
+(define acc (make-account 100))
+
+((acc 'deposit) 50)
+(printn "account:" ((acc 'withdraw) 30) ((acc 'withdraw) 500))
+
+
+
+
+; tail calls, which must not grow any stack
+(define (count-down n)
+	(if (= n 0)
+		'done
+		(count-down (- n 1))))
+
+(printn "self tail calls:" (count-down 200000))
+
+
+(define (ping n) (if (= n 0) 'ping (pong (- n 1))))
+(define (pong n) (if (= n 0) 'pong (ping (- n 1))))
+
+(printn "mutual tail calls:" (ping 100001))
+
+
+(define (tail-in-cond n acc)
+	(cond ((= n 0) acc)
+	      ((= (remainder n 2) 0) (tail-in-cond (- n 1) (+ acc 1)))
+	      (else (tail-in-cond (- n 1) acc))))
+
+(printn "tail calls in cond:" (tail-in-cond 100000 0))
+
+
+
+
+; let, letrec and do
+(printn "let:" (let ((a 2) (b 3)) (let ((a (* a b))) (list a b))))
+
+(printn "letrec:" (letrec ((fac (lambda (n)
+				(if (= n 0) 1 (* n (fac (- n 1)))))))
+			(fac 20)))
+
+(printn "named let:" (let loop ((i 0) (acc nil))
+			(if (= i 4) acc (loop (+ i 1) (cons i acc)))))
+
+(printn "do:" (do ((i 0 (+ i 1))
+		   (procs nil (cons (lambda () i) procs)))
+		  ((= i 3) (list ((car procs))
+				 ((car (cdr procs)))
+				 ((car (cdr (cdr procs))))))))
+
+
+
+
+; inline arithmetic and comparisons
+(printn "fixnums:" (+ 1 2) (- 1 2) (* 3 -4))
+(printn "doubles:" (+ 1.5 2) (- 1 0.25) (* 2.5 2.5))
+(printn "large longs:" (+ 4611686018427387903 1) (* 3037000499 3037000499))
+(printn "comparisons:" (= 2 2) (> 1 2) (>= 2 2.0) (< 1.5 2) (<= 3 2))
+(printn "more arguments:" (+ 1 2 3 4) (* 1 2 3 4) (- 10 1 2))
+
+
+(define (shadowed-plus a b)
+	(let ((+ -))
+		(+ a b)))
+
+(printn "shadowed +:" (shadowed-plus 5 3))
+
+
+(define (add a b) (+ a b))
+
+(printn "before redefinition:" (add 1 2))
+
+(define (+ a b) (list 'plus a b))
+
+(printn "after redefinition:" (add 1 2))
@@ -0,0 +1,117 @@
+; test_let.scm -- a test for let, letrec, named let and do of cscheme
+
+; Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+; This program is free software: you can redistribute it and/or modify
+; it under the terms of the GNU General Public License as published by
+; the Free Software Foundation, either version 3 of the License, or
+;(at your option) any later version.
+
+; This program is distributed in the hope that it will be useful,
+; but WITHOUT ANY WARRANTY; without even the implied warranty of
+; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+; GNU General Public License for more details.
+
+; You should have received a copy of the GNU General Public License
+; along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+(define (call-all procs)
+	(if (null? procs)
+		nil
+		(cons ((car procs)) (call-all (cdr procs)))))
+
+
+
+
+; let evaluates its inits in the outer environment
+(define x 1)
+
+(printn "let:" (let ((x 10) (y x)) (list x y)))
+
+(printn "nested let:" (let ((a 1))
+				(let ((b (+ a 1)))
+					(let ((a (* b 10)))
+						(list a b)))))
+
+
+; letrec makes the variables visible to all inits
+(printn "letrec:" (letrec ((even? (lambda (n)
+					(if (= n 0) #t (odd? (- n 1)))))
+			   (odd? (lambda (n)
+					(if (= n 0) #f (even? (- n 1))))))
+			(list (even? 100) (odd? 7) (even? 7))))
+
+
+; named let
+(printn "named let:" (let loop ((i 0) (acc nil))
+			(if (= i 5)
+				acc
+				(loop (+ i 1) (cons i acc)))))
+
+(printn "named let, 100000 iterations:" (let count ((n 100000) (sum 0))
+						(if (= n 0)
+							sum
+							(count (- n 1) (+ sum n)))))
+
+
+; do
+(printn "do:" (do ((i 0 (+ i 1))
+		   (acc nil (cons (* i i) acc)))
+		  ((= i 5) acc)))
+
+(printn "do with a body:" (let ((v nil))
+				(do ((i 3 (- i 1)))
+				    ((= i 0) v)
+					(set! v (cons i v)))))
+
+
+
+
+;	Every iteration of a named let or a do loop binds fresh
+; variables, even when the frame of the loop is rebound in place by a
+; self tail call, so the closures below must see different values.
+(printn "closures of named let:"
+	(call-all (let loop ((i 0) (procs nil))
+			(if (= i 3)
+				procs
+				(loop (+ i 1) (cons (lambda () i) procs))))))
+
+(printn "closures of do:"
+	(call-all (do ((i 0 (+ i 1))
+		       (procs nil (cons (lambda () i) procs)))
+		      ((= i 3) procs))))
+
+(printn "counters of named let:"
+	(let loop ((i 0) (procs nil))
+		(if (= i 3)
+			(call-all (call-all procs))
+			(loop (+ i 1)
+			      (cons (lambda ()
+					(set! i (+ i 10))
+					(lambda () i))
+				    procs)))))
+
+
+
+
+;	An internal definition may bind a parameter or a let variable
+; again, and closures made before it must see the new value.
+(define (redefine-param a)
+	(define (g) a)
+	(define a 9)
+	(g))
+
+(printn "redefined parameter:" (redefine-param 1))
+
+(printn "redefined let variable:" (let ((a 1))
+					(define (g) a)
+					(define a 9)
+					(g)))
+
+(define (redefine-param-twice a)
+	(define g (lambda () a))
+	(define a 2)
+	(define h (lambda () a))
+	(list (g) (h)))
+
+(printn "closures around a redefinition:" (redefine-param-twice 1))
@@ -21,8 +21,10 @@
 #include "ast.h"
 #include "object.h"
 #include "ef.h"
-#include "text.h"
+#include "symbol.h"
 #include "env.h"
+#include "cell.h"
+#include "scope.h"
 #include "var.h"
 
 
@@ -45,6 +47,29 @@ int cscm_is_var(CSCM_AST_NODE *exp)
 
 
 
+CSCM_VAR_EF_STATE *_cscm_var_ef_state_create()
+{
+	CSCM_VAR_EF_STATE *state;
+
+
+	state = malloc(sizeof(CSCM_VAR_EF_STATE));
+	if (state == NULL)
+		cscm_libc_fail("_cscm_var_ef_state_create", "malloc");
+
+
+	state->var = NULL;
+
+	state->addr = CSCM_SCOPE_ADDR_DYNAMIC;
+	state->depth = 0;
+	state->slot = 0;
+
+	state->cell = NULL;
+
+
+	return state;
+}
+
+
 CSCM_OBJECT *_cscm_var_ef(void *state, CSCM_OBJECT *env)
 {
 	CSCM_OBJECT *ret;
@@ -53,28 +78,91 @@ CSCM_OBJECT *_cscm_var_ef(void *state, CSCM_OBJECT *env)
 	if (state == NULL)
 		ret = CSCM_UNASSIGNED;
 	else
-		ret = cscm_env_get_var(env, (char *)state);
+		ret = cscm_env_get_var(env, \
+				((CSCM_VAR_EF_STATE *)state)->var);
 
 
 	return ret;
 }
 
 
+CSCM_OBJECT *_cscm_var_ef_local(void *state, CSCM_OBJECT *env)
+{
+	CSCM_VAR_EF_STATE *s;
+
+
+	s = (CSCM_VAR_EF_STATE *)state;
+
+
+	return cscm_env_get_var_at(env, s->depth, s->slot, s->var);
+}
+
+
+/*	Global variables are shared by all environments, so the cell
+ * of the variable is kept in the state once it is bound, and later
+ * evaluations read the value from the cell directly. */
+CSCM_OBJECT *cscm_var_get_global(CSCM_VAR_EF_STATE *state, CSCM_OBJECT *env)
+{
+	CSCM_OBJECT *val;
+
+
+	if (state->cell == NULL)
+		state->cell = cscm_env_get_global_cell(env, state->var);
+
+
+	val = CSCM_CELL_GET(state->cell);
+	if (val == CSCM_UNASSIGNED)
+		cscm_runtime_error_report(state->var, \
+				CSCM_ERROR_FRAME_UNASSIGNED);
+
+
+	return val;
+}
+
+
+CSCM_OBJECT *_cscm_var_ef_global(void *state, CSCM_OBJECT *env)
+{
+	return cscm_var_get_global((CSCM_VAR_EF_STATE *)state, env);
+}
+
+
 CSCM_EF *cscm_analyze_var(CSCM_AST_NODE *exp)
 {
-	char *name;
+	CSCM_VAR_EF_STATE *state;
+	CSCM_EF_FUNC f;
 
 
 	if (cscm_ast_symbol_text_equal(exp, "**UNASSIGNED**"))
-		name = NULL;
-	else
-		name = cscm_text_cpy(exp->text);
+		return cscm_ef_construct(CSCM_EF_TYPE_VAR,	\
+					NULL,			\
+					NULL,			\
+					_cscm_var_ef);
+
+
+	state = _cscm_var_ef_state_create();
+	state->var = cscm_symbol_intern_text(exp->text);
+
+	state->addr = cscm_scope_resolve(state->var,	\
+					&state->depth,	\
+					&state->slot);
+
+	switch (state->addr)
+	{
+		case CSCM_SCOPE_ADDR_LOCAL:
+			f = _cscm_var_ef_local;
+			break;
+		case CSCM_SCOPE_ADDR_GLOBAL:
+			f = _cscm_var_ef_global;
+			break;
+		default:
+			f = _cscm_var_ef;
+	}
 
 
 	return cscm_ef_construct(CSCM_EF_TYPE_VAR,	\
-				name,			\
+				state,			\
 				NULL,			\
-				_cscm_var_ef);
+				f);
 }
 
 
@@ -82,6 +170,9 @@ CSCM_EF *cscm_analyze_var(CSCM_AST_NODE *exp)
 
 void cscm_var_ef_free(CSCM_EF *ef)
 {
+	CSCM_VAR_EF_STATE *state;
+
+
 	if (ef == NULL)
 		cscm_error_report("cscm_var_ef_free", \
 				CSCM_ERROR_NULL_PTR);
@@ -90,8 +181,10 @@ void cscm_var_ef_free(CSCM_EF *ef)
 				CSCM_ERROR_EF_TYPE);
 
 
-	if (ef->state)
-		free(ef->state);
+	state = (CSCM_VAR_EF_STATE *)ef->state;
+
+	if (state) // state->var is interned
+		free(state);
 
 
 	free(ef);
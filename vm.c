@@ -0,0 +1,725 @@
+/* vm.c -- virtual machine executing bytecode
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "object.h"
+#include "ef.h"
+#include "env.h"
+#include "bool.h"
+#include "proc.h"
+#include "lambda.h"
+#include "let.h"
+#include "var.h"
+#include "scope.h"
+#include "gc.h"
+#include "tco.h"
+#include "core.h"
+#include "builtin.h"
+#include "vm.h"
+
+
+
+
+int cscm_vm_mode = 0; // set by --engine=vm
+
+
+
+
+size_t _cscm_vm_n_frames = 0;
+size_t _cscm_vm_frames_size = 0;
+CSCM_VM_FRAME *_cscm_vm_frames = NULL;
+
+
+void _cscm_vm_frame_push()
+{
+	if (_cscm_vm_n_frames == _cscm_vm_frames_size) {
+		if (_cscm_vm_frames_size == 0)
+			_cscm_vm_frames_size = CSCM_VM_FRAMES_INIT_SIZE;
+		else
+			_cscm_vm_frames_size *= 2;
+
+		_cscm_vm_frames = realloc(_cscm_vm_frames,		     \
+					sizeof(CSCM_VM_FRAME)		     \
+					* _cscm_vm_frames_size);
+		if (_cscm_vm_frames == NULL)
+			cscm_libc_fail("_cscm_vm_frame_push", "realloc");
+	}
+
+
+	_cscm_vm_n_frames++;
+}
+
+
+
+
+void **_cscm_vm_handlers = NULL;
+
+
+void **cscm_vm_get_handlers()
+{
+	if (_cscm_vm_handlers == NULL)
+		cscm_vm_run(NULL, NULL);
+
+
+	return _cscm_vm_handlers;
+}
+
+
+
+
+/*	Instructions jump to their handlers directly through labels as
+ * values, which is a GNU C extension.
+ *	Values on the operand stack of an activation are not counted,
+ * and every slot above sp is kept NULL, since the stack of temporaries
+ * is walked by garbage collections. */
+#define _CSCM_VM_NEXT()		goto *pc->handler
+
+
+#define _CSCM_VM_POP(val)	\
+	do {			\
+		val = *--sp;	\
+		*sp = NULL;	\
+	} while (0)
+
+
+CSCM_OBJECT *cscm_vm_run(CSCM_VM_CODE *code, CSCM_OBJECT *env)
+{
+	static void *handlers[] = {
+		&&op_const,
+		&&op_local,
+		&&op_global,
+		&&op_dynamic,
+		&&op_set_local,
+		&&op_set_global,
+		&&op_set_dynamic,
+		&&op_define,
+		&&op_lambda,
+		&&op_pop,
+		&&op_jump,
+		&&op_jump_if_false,
+		&&op_and,
+		&&op_or,
+		&&op_call,
+		&&op_tail_call,
+		&&op_call_known,
+		&&op_tail_call_known,
+		&&op_let,
+		&&op_tail_let,
+		&&op_letrec,
+		&&op_tail_letrec,
+		&&op_init,
+		&&op_make_cells,
+		&&op_ef,
+		&&op_inline,
+		&&op_tail_inline,
+		&&op_return
+	};
+
+	int i;
+
+	size_t n, bottom;
+	int flag_tail, flag_tco_allow;
+
+	CSCM_VM_INST *pc;
+	CSCM_OBJECT **base, **sp, **args;
+	int flag_owned;
+
+	CSCM_VM_FRAME *frame;
+
+	CSCM_OBJECT *val, *proc, *new_env, *frame_obj;
+	CSCM_PROC_PRIM_FUNC f;
+	CSCM_EF *ef, *body;
+	CSCM_LAMBDA_EF_STATE *lambda;
+	CSCM_LET_EF_STATE *let;
+	CSCM_SCOPE_CELLS *cells;
+
+
+	if (code == NULL) { // export the handlers to the compiler
+		_cscm_vm_handlers = handlers;
+
+		return NULL;
+	} else if (env == NULL) {
+		cscm_error_report("cscm_vm_run", CSCM_ERROR_NULL_PTR);
+	}
+
+
+	/* tail calls are left to the loop instead of cscm_apply_body() */
+	flag_tco_allow = cscm_tco_get_flag(CSCM_TCO_FLAG_ALLOW);
+	cscm_tco_unset_flag(CSCM_TCO_FLAG_ALLOW);
+
+
+	/*	env belongs to the caller, so it is never reused by tail
+	 * calls of the first activation. */
+	bottom = _cscm_vm_n_frames;
+	_cscm_vm_frame_push();
+
+	base = cscm_object_ptrs_push(code->max_depth);
+	sp = base;
+	flag_owned = 0;
+
+	pc = code->insts;
+	_CSCM_VM_NEXT();
+
+
+
+
+op_const:
+	*sp++ = pc->ptr;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_local:
+	*sp++ = cscm_env_get_var_at(env, pc->a, pc->b, pc->ptr);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_global: // ptr is the state of the variable
+	*sp++ = cscm_var_get_global((CSCM_VAR_EF_STATE *)pc->ptr, env);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_dynamic:
+	*sp++ = cscm_env_get_var(env, pc->ptr);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+
+
+/*	The new value may be freed with the old one when it is only
+ * referenced by the old one, see _cscm_assignment_ef(). */
+op_set_local:
+	val = sp[-1];
+
+	cscm_gc_inc(val);
+	cscm_env_set_var_at(env, pc->a, pc->b, pc->ptr, val);
+	cscm_gc_dec(val);
+
+	sp[-1] = CSCM_TRUE;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_set_global:
+	val = sp[-1];
+
+	cscm_gc_inc(val);
+	cscm_env_set_global_var(env, pc->ptr, val);
+	cscm_gc_dec(val);
+
+	sp[-1] = CSCM_TRUE;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_set_dynamic:
+	val = sp[-1];
+
+	cscm_gc_inc(val);
+	cscm_env_set_var(env, pc->ptr, val);
+	cscm_gc_dec(val);
+
+	sp[-1] = CSCM_TRUE;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_define:
+	cscm_env_add_var(env, pc->ptr, sp[-1]);
+
+	sp[-1] = NULL; // definitions have no value
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+
+
+op_lambda:
+	ef = (CSCM_EF *)pc->ptr;
+
+	*sp++ = ef->f(ef->state, env);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_ef:
+	*sp++ = cscm_ef_exec((CSCM_EF *)pc->ptr, env);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+
+
+op_pop:
+	_CSCM_VM_POP(val);
+
+	if (val)
+		cscm_gc_free(val);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_jump:
+	pc = pc->target;
+	_CSCM_VM_NEXT();
+
+
+op_jump_if_false:
+	_CSCM_VM_POP(val);
+
+	if (val == CSCM_FALSE) {
+		pc = pc->target;
+	} else {
+		if (val)
+			cscm_gc_free(val);
+
+		pc++;
+	}
+
+	_CSCM_VM_NEXT();
+
+
+op_and:
+	if (sp[-1] == CSCM_FALSE) {
+		pc = pc->target;
+	} else {
+		_CSCM_VM_POP(val);
+
+		if (val)
+			cscm_gc_free(val);
+
+		pc++;
+	}
+
+	_CSCM_VM_NEXT();
+
+
+op_or:
+	if (sp[-1] != CSCM_FALSE) {
+		pc = pc->target;
+	} else {
+		_CSCM_VM_POP(val);
+
+		pc++;
+	}
+
+	_CSCM_VM_NEXT();
+
+
+
+
+op_call:
+	flag_tail = 0;
+	goto call;
+
+op_tail_call:
+	flag_tail = 1;
+
+call:
+	n = pc->a;
+	args = sp - n;
+	proc = args[-1];
+
+	if (proc == NULL)
+		cscm_error_report("cscm_apply", \
+				CSCM_ERROR_APPLY_NO_PROC);
+
+
+	if (CSCM_OBJECT_GET_TYPE(proc) == CSCM_OBJECT_TYPE_PROC_PRIM) {
+		f = cscm_proc_prim_get_f(proc);
+		val = f(n, args);
+
+		/* see _cscm_apply() */
+		for (i = 0; i < n; i++) {
+			if (args[i] != val)
+				cscm_gc_free(args[i]);
+
+			args[i] = NULL;
+		}
+
+		cscm_gc_free(proc);
+
+		sp = args - 1;
+		*sp++ = val;
+
+		if (flag_tail)
+			goto op_return;
+
+		pc++;
+		_CSCM_VM_NEXT();
+	} else if (CSCM_OBJECT_GET_TYPE(proc) == CSCM_OBJECT_TYPE_PROC_COMP) {
+		new_env = cscm_apply_env(flag_tail && flag_owned ? env : NULL, \
+				cscm_proc_comp_get_env(proc),		     \
+				cscm_proc_comp_get_flag_dtn(proc),	     \
+				cscm_proc_comp_get_flag_stacked(proc),	     \
+				cscm_proc_comp_get_n_params(proc),	     \
+				cscm_proc_comp_get_params(proc),	     \
+				cscm_proc_comp_get_frame_size(proc),	     \
+				n,					     \
+				args);
+
+		/*	The body belongs to the lambda expression, and new_env
+		 * keeps the environment of proc. */
+		body = cscm_proc_comp_get_body(proc);
+
+		sp = args - 1;
+		*sp = NULL;
+
+		cscm_gc_free(proc);
+
+		goto apply;
+	} else {
+		cscm_error_report("cscm_apply", CSCM_ERROR_OBJECT_TYPE);
+	}
+
+
+/*	The operator is applied by op_call unless it is still the
+ * primitive the combination was compiled for, see
+ * _cscm_combination_ef_inline(). */
+op_inline:
+	flag_tail = 0;
+	goto inline_apply;
+
+op_tail_inline:
+	flag_tail = 1;
+
+inline_apply:
+	proc = sp[-3];
+
+	if (proc == NULL						\
+		|| CSCM_OBJECT_GET_TYPE(proc) != CSCM_OBJECT_TYPE_PROC_PRIM	\
+		|| cscm_proc_prim_get_f(proc) != cscm_builtin_inline_get_f(pc->b))
+		goto call;
+
+	val = cscm_builtin_inline_apply(pc->b, sp[-2], sp[-1]);
+	if (val == NULL)
+		goto call;
+
+
+	/* see op_call */
+	for (i = 1; i <= 2; i++) {
+		if (sp[-i] != val)
+			cscm_gc_free(sp[-i]);
+
+		sp[-i] = NULL;
+	}
+
+	cscm_gc_free(proc);
+
+	sp -= 3;
+	*sp++ = val;
+
+	if (flag_tail)
+		goto op_return;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_call_known:
+	flag_tail = 0;
+	goto call_known;
+
+op_tail_call_known:
+	flag_tail = 1;
+
+call_known:
+	n = pc->a;
+	args = sp - n;
+
+	lambda = (CSCM_LAMBDA_EF_STATE *)(*(CSCM_EF **)pc->ptr)->state;
+
+	new_env = cscm_apply_env(flag_tail && flag_owned ? env : NULL,	\
+				cscm_env_get_outer(env, pc->b),		\
+				lambda->flag_dtn,			\
+				lambda->flag_stacked,			\
+				lambda->n_params,			\
+				lambda->params,				\
+				lambda->frame_size,			\
+				n,					\
+				args);
+
+	body = lambda->body;
+
+	sp = args;
+
+
+/*	Compiled bodies are executed by new activations, while others
+ * are left to cscm_apply_body(). */
+apply:
+	if (body->type == CSCM_EF_TYPE_VM) {
+		code = ((CSCM_VM_EF_STATE *)body->state)->code;
+		goto enter;
+	}
+
+	*sp++ = cscm_apply_body(body, new_env);
+
+	if (flag_tail)
+		goto op_return;
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+
+
+op_let:
+	flag_tail = 0;
+	goto let;
+
+op_tail_let:
+	flag_tail = 1;
+
+let:
+	let = (CSCM_LET_EF_STATE *)pc->ptr;
+
+	frame_obj = cscm_frame_create(let->frame_size);
+
+	if (let->n_vars > 0) {
+		args = sp - let->n_vars;
+
+		cscm_frame_init(frame_obj, let->n_vars, let->vars, args);
+
+		for (i = 0; i < let->n_vars; i++)
+			args[i] = NULL;
+
+		sp = args;
+	}
+
+	goto let_env;
+
+
+op_letrec:
+	flag_tail = 0;
+	goto letrec;
+
+op_tail_letrec:
+	flag_tail = 1;
+
+letrec:
+	let = (CSCM_LET_EF_STATE *)pc->ptr;
+
+	frame_obj = cscm_frame_create(let->frame_size);
+
+	for (i = 0; i < let->n_vars; i++)
+		cscm_frame_add_var(frame_obj, let->vars[i], CSCM_UNASSIGNED);
+
+let_env:
+	if (let->cells)
+		cscm_frame_make_cells(frame_obj,		\
+				let->cells->n_cells,		\
+				let->cells->slots,		\
+				let->cells->vars);
+
+	new_env = cscm_env_extend(env, frame_obj);
+	cscm_gc_inc(new_env);
+
+	code = pc->code;
+
+
+/*	Enter code with new_env, which has been counted. A tail call
+ * replaces the current activation, whose environment is released
+ * first unless it belongs to the caller of cscm_vm_run(). */
+enter:
+	if (flag_tail) {
+		if (flag_owned) {
+			cscm_gc_dec(env);
+			cscm_gc_free(env);
+		}
+
+		cscm_object_ptrs_pop(base);
+	} else {
+		frame = &_cscm_vm_frames[_cscm_vm_n_frames - 1];
+
+		frame->pc = pc + 1;
+		frame->base = base;
+		frame->sp = sp;
+		frame->env = env;
+		frame->flag_owned = flag_owned;
+
+		_cscm_vm_frame_push();
+	}
+
+	base = cscm_object_ptrs_push(code->max_depth);
+	sp = base;
+
+	env = new_env;
+	flag_owned = 1;
+
+	pc = code->insts;
+
+
+	cscm_gc_check();
+
+	_CSCM_VM_NEXT();
+
+
+op_init:
+	_CSCM_VM_POP(val);
+
+	cscm_frame_set_var(cscm_env_get_frame(env, 0), pc->ptr, val);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+op_make_cells:
+	cells = (CSCM_SCOPE_CELLS *)pc->ptr;
+
+	cscm_frame_make_cells(cscm_env_get_frame(env, 0),	\
+				cells->n_cells,			\
+				cells->slots,			\
+				cells->vars);
+
+	pc++;
+	_CSCM_VM_NEXT();
+
+
+
+
+/*	The value is left to the table if env was its last owner, see
+ * cscm_apply_body(). */
+op_return:
+	_CSCM_VM_POP(val);
+
+	if (flag_owned) {
+		cscm_gc_dec(env);
+		cscm_gc_free(env);
+	}
+
+	cscm_object_ptrs_pop(base);
+
+	_cscm_vm_n_frames--;
+	if (_cscm_vm_n_frames == bottom) {
+		if (flag_tco_allow) // restore the original value of the flag
+			cscm_tco_set_flag(CSCM_TCO_FLAG_ALLOW);
+
+		return val;
+	}
+
+
+	frame = &_cscm_vm_frames[_cscm_vm_n_frames - 1];
+
+	pc = frame->pc;
+	base = frame->base;
+	sp = frame->sp;
+	env = frame->env;
+	flag_owned = frame->flag_owned;
+
+	*sp++ = val;
+
+	_CSCM_VM_NEXT();
+}
+
+
+
+
+CSCM_OBJECT *cscm_vm_exec(CSCM_EF *ef, CSCM_OBJECT *env)
+{
+	CSCM_VM_CODE *code;
+	CSCM_OBJECT *ret;
+
+
+	code = cscm_vm_compile(ef);
+
+	ret = cscm_vm_run(code, env);
+
+	cscm_vm_code_free(code);
+
+
+	return ret;
+}
+
+
+
+
+CSCM_OBJECT *_cscm_vm_ef(void *state, CSCM_OBJECT *env)
+{
+	return cscm_vm_run(((CSCM_VM_EF_STATE *)state)->code, env);
+}
+
+
+/*	The execution function is not pushed into the backtrace,
+ * since it has no expression of its own. */
+CSCM_EF *cscm_vm_ef_construct(CSCM_VM_CODE *code, CSCM_EF *ef)
+{
+	CSCM_VM_EF_STATE *state;
+
+
+	if (code == NULL || ef == NULL)
+		cscm_error_report("cscm_vm_ef_construct", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	state = malloc(sizeof(CSCM_VM_EF_STATE));
+	if (state == NULL)
+		cscm_libc_fail("cscm_vm_ef_construct", "malloc");
+
+
+	state->code = code;
+	state->ef = ef;
+
+
+	return cscm_ef_construct(CSCM_EF_TYPE_VM,	\
+				state,			\
+				NULL,			\
+				_cscm_vm_ef);
+}
+
+
+
+
+void cscm_vm_ef_free(CSCM_EF *ef)
+{
+	CSCM_VM_EF_STATE *state;
+
+
+	if (ef == NULL)
+		cscm_error_report("cscm_vm_ef_free", \
+				CSCM_ERROR_NULL_PTR);
+	else if (ef->type != CSCM_EF_TYPE_VM)
+		cscm_error_report("cscm_vm_ef_free", \
+				CSCM_ERROR_EF_TYPE);
+
+
+	state = (CSCM_VM_EF_STATE *)ef->state;
+
+	cscm_vm_code_free(state->code);
+	cscm_ef_free_tree(state->ef);
+
+	free(state);
+
+
+	free(ef);
+}
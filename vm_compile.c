@@ -0,0 +1,581 @@
+/* vm_compile.c -- compiling execution functions into bytecode
+
+   Copyright (C) 2022 Tongjie Liu <tongjieandliu@gmail.com>.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.*/
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "object.h"
+#include "ef.h"
+#include "env.h"
+#include "var.h"
+#include "assignment.h"
+#include "definition.h"
+#include "lambda.h"
+#include "if.h"
+#include "begin.h"
+#include "logical.h"
+#include "let.h"
+#include "core.h"
+#include "builtin.h"
+#include "scope.h"
+#include "vm.h"
+
+
+
+
+CSCM_VM_CODE *cscm_vm_code_create()
+{
+	CSCM_VM_CODE *code;
+
+
+	code = malloc(sizeof(CSCM_VM_CODE));
+	if (code == NULL)
+		cscm_libc_fail("cscm_vm_code_create", "malloc");
+
+
+	code->n_insts = 0;
+	code->size = CSCM_VM_CODE_INIT_SIZE;
+
+	code->insts = malloc(sizeof(CSCM_VM_INST) * code->size);
+	if (code->insts == NULL)
+		cscm_libc_fail("cscm_vm_code_create", "malloc");
+
+
+	code->depth = 0;
+	code->max_depth = 0;
+
+	code->n_codes = 0;
+	code->codes = NULL;
+
+
+	return code;
+}
+
+
+void cscm_vm_code_free(CSCM_VM_CODE *code)
+{
+	int i;
+
+
+	if (code == NULL)
+		cscm_error_report("cscm_vm_code_free", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	for (i = 0; i < code->n_codes; i++)
+		cscm_vm_code_free(code->codes[i]);
+
+	if (code->codes)
+		free(code->codes);
+
+
+	free(code->insts);
+
+	free(code);
+}
+
+
+
+
+/* return the index of the new instruction */
+size_t _cscm_vm_emit(CSCM_VM_CODE *code,		\
+		int op, size_t a, size_t b, void *ptr)
+{
+	CSCM_VM_INST *inst;
+
+
+	if (code->n_insts == code->size) {
+		code->size *= 2;
+
+		code->insts = realloc(code->insts,	\
+				sizeof(CSCM_VM_INST) * code->size);
+		if (code->insts == NULL)
+			cscm_libc_fail("_cscm_vm_emit", "realloc");
+	}
+
+
+	inst = &code->insts[code->n_insts];
+
+	inst->handler = NULL;
+	inst->op = op;
+
+	inst->a = a;
+	inst->b = b;
+	inst->ptr = ptr;
+
+	inst->target = NULL;
+	inst->code = NULL;
+
+
+	return code->n_insts++;
+}
+
+
+void _cscm_vm_push(CSCM_VM_CODE *code, size_t n)
+{
+	code->depth += n;
+
+	if (code->depth > code->max_depth)
+		code->max_depth = code->depth;
+}
+
+
+void _cscm_vm_pop(CSCM_VM_CODE *code, size_t n)
+{
+	code->depth -= n;
+}
+
+
+void _cscm_vm_add_code(CSCM_VM_CODE *code, CSCM_VM_CODE *sub)
+{
+	code->codes = realloc(code->codes,				\
+			sizeof(CSCM_VM_CODE *) * (code->n_codes + 1));
+	if (code->codes == NULL)
+		cscm_libc_fail("_cscm_vm_add_code", "realloc");
+
+
+	code->codes[code->n_codes++] = sub;
+}
+
+
+/*	Thread the instructions through the handlers of the loop, and
+ * turn the indexes of jumps into their targets. */
+void _cscm_vm_code_finish(CSCM_VM_CODE *code)
+{
+	int i;
+
+	void **handlers;
+	CSCM_VM_INST *inst;
+
+
+	handlers = cscm_vm_get_handlers();
+
+
+	for (i = 0; i < code->n_insts; i++) {
+		inst = &code->insts[i];
+
+		inst->handler = handlers[inst->op];
+
+		if (inst->op == CSCM_VM_OP_JUMP			\
+			|| inst->op == CSCM_VM_OP_JUMP_IF_FALSE	\
+			|| inst->op == CSCM_VM_OP_AND		\
+			|| inst->op == CSCM_VM_OP_OR)
+			inst->target = &code->insts[inst->a];
+	}
+
+
+	/* operand stacks can not be empty */
+	if (code->max_depth == 0)
+		code->max_depth = 1;
+}
+
+
+
+
+void _cscm_vm_compile(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail);
+
+
+/*	An expression in a tail position ends the activation, either by
+ * a tail call or by returning its value. */
+void _cscm_vm_compile_return(CSCM_VM_CODE *code, int flag_tail)
+{
+	if (flag_tail) {
+		_cscm_vm_emit(code, CSCM_VM_OP_RETURN, 0, 0, NULL);
+		_cscm_vm_pop(code, 1);
+	}
+}
+
+
+void _cscm_vm_compile_var(CSCM_VM_CODE *code, CSCM_EF *ef)
+{
+	CSCM_VAR_EF_STATE *s;
+
+
+	s = (CSCM_VAR_EF_STATE *)ef->state;
+
+	if (s == NULL)
+		_cscm_vm_emit(code, CSCM_VM_OP_CONST, 0, 0, CSCM_UNASSIGNED);
+	else if (s->addr == CSCM_SCOPE_ADDR_LOCAL)
+		_cscm_vm_emit(code, CSCM_VM_OP_LOCAL, s->depth, s->slot, s->var);
+	else if (s->addr == CSCM_SCOPE_ADDR_GLOBAL)
+		_cscm_vm_emit(code, CSCM_VM_OP_GLOBAL, 0, 0, s);
+	else
+		_cscm_vm_emit(code, CSCM_VM_OP_DYNAMIC, 0, 0, s->var);
+
+	_cscm_vm_push(code, 1);
+}
+
+
+void _cscm_vm_compile_assignment(CSCM_VM_CODE *code, CSCM_EF *ef)
+{
+	int op;
+	CSCM_ASSIGNMENT_EF_STATE *s;
+
+
+	s = (CSCM_ASSIGNMENT_EF_STATE *)ef->state;
+
+	if (s->addr == CSCM_SCOPE_ADDR_LOCAL)
+		op = CSCM_VM_OP_SET_LOCAL;
+	else if (s->addr == CSCM_SCOPE_ADDR_GLOBAL)
+		op = CSCM_VM_OP_SET_GLOBAL;
+	else
+		op = CSCM_VM_OP_SET_DYNAMIC;
+
+
+	/* the value is replaced by #t */
+	_cscm_vm_compile(code, s->val_ef, 0);
+	_cscm_vm_emit(code, op, s->depth, s->slot, s->var);
+}
+
+
+void _cscm_vm_compile_if(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	size_t depth, jump_if_false, jump;
+	CSCM_IF_EF_STATE *s;
+
+
+	s = (CSCM_IF_EF_STATE *)ef->state;
+
+
+	_cscm_vm_compile(code, s->predicate_ef, 0);
+
+	jump_if_false = _cscm_vm_emit(code,			\
+				CSCM_VM_OP_JUMP_IF_FALSE,	\
+				0, 0, NULL);
+	_cscm_vm_pop(code, 1);
+
+	depth = code->depth;
+
+
+	_cscm_vm_compile(code, s->consequent_ef, flag_tail);
+
+	if (!flag_tail)
+		jump = _cscm_vm_emit(code, CSCM_VM_OP_JUMP, 0, 0, NULL);
+
+
+	code->insts[jump_if_false].a = code->n_insts;
+	code->depth = depth;
+
+	if (s->alternative_ef) {
+		_cscm_vm_compile(code, s->alternative_ef, flag_tail);
+	} else {
+		_cscm_vm_emit(code, CSCM_VM_OP_CONST, 0, 0, NULL);
+		_cscm_vm_push(code, 1);
+
+		_cscm_vm_compile_return(code, flag_tail);
+	}
+
+
+	if (!flag_tail)
+		code->insts[jump].a = code->n_insts;
+}
+
+
+void _cscm_vm_compile_seq(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	int i, end;
+	CSCM_SEQ_EF_STATE *s;
+
+
+	s = (CSCM_SEQ_EF_STATE *)ef->state;
+
+
+	end = s->n_clause_efs - 1;
+	for (i = 0; i < end; i++) {
+		_cscm_vm_compile(code, s->clause_efs[i], 0);
+
+		_cscm_vm_emit(code, CSCM_VM_OP_POP, 0, 0, NULL);
+		_cscm_vm_pop(code, 1);
+	}
+
+
+	_cscm_vm_compile(code, s->clause_efs[end], flag_tail);
+}
+
+
+/*	Every clause but the last one jumps to the end with its value
+ * when the value decides the result. */
+void _cscm_vm_compile_ao(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	int i, end;
+
+	int op;
+	size_t *jumps;
+
+	CSCM_AO_EF_STATE *s;
+
+
+	s = (CSCM_AO_EF_STATE *)ef->state;
+
+	op = s->flag_or ? CSCM_VM_OP_OR : CSCM_VM_OP_AND;
+
+
+	end = s->n_clause_efs - 1;
+
+	jumps = end ? malloc(sizeof(size_t) * end) : NULL;
+	if (end && jumps == NULL)
+		cscm_libc_fail("_cscm_vm_compile_ao", "malloc");
+
+	for (i = 0; i < end; i++) {
+		_cscm_vm_compile(code, s->clause_efs[i], 0);
+
+		jumps[i] = _cscm_vm_emit(code, op, 0, 0, NULL);
+		_cscm_vm_pop(code, 1);
+	}
+
+
+	_cscm_vm_compile(code, s->clause_efs[end], flag_tail);
+
+	for (i = 0; i < end; i++)
+		code->insts[jumps[i]].a = code->n_insts;
+
+	if (end) {
+		if (flag_tail) { // values of the jumps are returned here
+			_cscm_vm_push(code, 1);
+			_cscm_vm_compile_return(code, flag_tail);
+		}
+
+		free(jumps);
+	}
+}
+
+
+void _cscm_vm_compile_combination(CSCM_VM_CODE *code,	\
+				CSCM_EF *ef,		\
+				int flag_tail)
+{
+	int i;
+	CSCM_COMBINATION_EF_STATE *s;
+
+
+	s = (CSCM_COMBINATION_EF_STATE *)ef->state;
+
+
+	if (s->proc_ef)
+		_cscm_vm_compile(code, s->proc_ef, 0);
+
+	for (i = 0; i < s->n_arg_efs; i++)
+		_cscm_vm_compile(code, s->arg_efs[i], 0);
+
+
+	if (s->proc_ef && s->op != CSCM_BUILTIN_INLINE_NONE) {
+		_cscm_vm_emit(code,					\
+			flag_tail					\
+			? CSCM_VM_OP_TAIL_INLINE : CSCM_VM_OP_INLINE,	\
+			s->n_arg_efs, s->op, NULL);
+
+		_cscm_vm_pop(code, s->n_arg_efs + 1);
+	} else if (s->proc_ef) {
+		_cscm_vm_emit(code,					\
+			flag_tail					\
+			? CSCM_VM_OP_TAIL_CALL : CSCM_VM_OP_CALL,	\
+			s->n_arg_efs, 0, NULL);
+
+		_cscm_vm_pop(code, s->n_arg_efs + 1);
+	} else {
+		_cscm_vm_emit(code,					     \
+			flag_tail					     \
+			? CSCM_VM_OP_TAIL_CALL_KNOWN : CSCM_VM_OP_CALL_KNOWN, \
+			s->n_arg_efs, s->depth, s->lambda_ef_ptr);
+
+		_cscm_vm_pop(code, s->n_arg_efs);
+	}
+
+	if (!flag_tail)
+		_cscm_vm_push(code, 1);
+}
+
+
+/*	The body of a let expression is compiled into code of its own,
+ * which is executed in a new activation like the body of a procedure.
+ * The inits of a letrec expression are part of that code, since they
+ * are evaluated in the new environment. */
+void _cscm_vm_compile_let(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	int i;
+
+	int op;
+	size_t index;
+
+	CSCM_LET_EF_STATE *s;
+	CSCM_VM_CODE *body;
+
+
+	s = (CSCM_LET_EF_STATE *)ef->state;
+
+	body = cscm_vm_code_create();
+
+
+	if (s->flag_rec) {
+		for (i = 0; i < s->n_vars; i++) {
+			if (s->proc_efs[i])
+				cscm_vm_compile_lambda(s->proc_efs[i]);
+
+			if (s->init_efs[i] == NULL)
+				continue;
+
+			_cscm_vm_compile(body, s->init_efs[i], 0);
+
+			_cscm_vm_emit(body, CSCM_VM_OP_INIT, 0, 0, s->vars[i]);
+			_cscm_vm_pop(body, 1);
+		}
+
+		op = flag_tail ? CSCM_VM_OP_TAIL_LETREC : CSCM_VM_OP_LETREC;
+	} else {
+		for (i = 0; i < s->n_vars; i++)
+			_cscm_vm_compile(code, s->init_efs[i], 0);
+
+		_cscm_vm_pop(code, s->n_vars);
+
+		op = flag_tail ? CSCM_VM_OP_TAIL_LET : CSCM_VM_OP_LET;
+	}
+
+	_cscm_vm_compile(body, s->body, 1);
+	_cscm_vm_code_finish(body);
+
+
+	index = _cscm_vm_emit(code, op, s->n_vars, 0, s);
+	code->insts[index].code = body;
+
+	_cscm_vm_add_code(code, body);
+
+	if (!flag_tail)
+		_cscm_vm_push(code, 1);
+}
+
+
+void _cscm_vm_compile_body(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	CSCM_LAMBDA_BODY_EF_STATE *s;
+
+
+	s = (CSCM_LAMBDA_BODY_EF_STATE *)ef->state;
+
+	_cscm_vm_emit(code, CSCM_VM_OP_MAKE_CELLS, 0, 0, s->cells);
+
+	_cscm_vm_compile(code, s->body, flag_tail);
+}
+
+
+void _cscm_vm_compile(CSCM_VM_CODE *code, CSCM_EF *ef, int flag_tail)
+{
+	switch (ef->type)
+	{
+		case CSCM_EF_TYPE_NUM_LONG:
+		case CSCM_EF_TYPE_NUM_DOUBLE:
+		case CSCM_EF_TYPE_SYMBOL:
+		case CSCM_EF_TYPE_STRING:
+		case CSCM_EF_TYPE_QUOTE: // states are the objects
+			_cscm_vm_emit(code, CSCM_VM_OP_CONST, 0, 0, ef->state);
+			_cscm_vm_push(code, 1);
+			break;
+		case CSCM_EF_TYPE_VAR:
+			_cscm_vm_compile_var(code, ef);
+			break;
+		case CSCM_EF_TYPE_ASSIGNMENT:
+			_cscm_vm_compile_assignment(code, ef);
+			break;
+		case CSCM_EF_TYPE_DEFINITION:
+			_cscm_vm_compile(code,				\
+				((CSCM_DEFINITION_EF_STATE *)ef->state)->val_ef, \
+				0);
+
+			_cscm_vm_emit(code, CSCM_VM_OP_DEFINE, 0, 0,	\
+				((CSCM_DEFINITION_EF_STATE *)ef->state)->var);
+			break;
+		case CSCM_EF_TYPE_LAMBDA:
+			cscm_vm_compile_lambda(ef);
+
+			_cscm_vm_emit(code, CSCM_VM_OP_LAMBDA, 0, 0, ef);
+			_cscm_vm_push(code, 1);
+			break;
+		case CSCM_EF_TYPE_IF:
+			_cscm_vm_compile_if(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_SEQ:
+			_cscm_vm_compile_seq(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_AO:
+			_cscm_vm_compile_ao(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_COMBINATION:
+			_cscm_vm_compile_combination(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_LET:
+			_cscm_vm_compile_let(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_BODY:
+			_cscm_vm_compile_body(code, ef, flag_tail);
+			return;
+		case CSCM_EF_TYPE_QUASIQUOTE: // left to its execution function
+			_cscm_vm_emit(code, CSCM_VM_OP_EF, 0, 0, ef);
+			_cscm_vm_push(code, 1);
+			break;
+		default:
+			cscm_error_report("_cscm_vm_compile", \
+					CSCM_ERROR_EF_TYPE);
+	}
+
+
+	_cscm_vm_compile_return(code, flag_tail);
+}
+
+
+
+
+CSCM_VM_CODE *cscm_vm_compile(CSCM_EF *ef)
+{
+	CSCM_VM_CODE *code;
+
+
+	if (ef == NULL)
+		cscm_error_report("cscm_vm_compile", \
+				CSCM_ERROR_NULL_PTR);
+
+
+	code = cscm_vm_code_create();
+
+	_cscm_vm_compile(code, ef, 1);
+	_cscm_vm_code_finish(code);
+
+
+	return code;
+}
+
+
+/*	Replace the body of a lambda expression with its code, which
+ * is also executed when the procedure is applied by cscm_apply(). */
+void cscm_vm_compile_lambda(CSCM_EF *ef)
+{
+	CSCM_LAMBDA_EF_STATE *s;
+
+
+	if (ef == NULL)
+		cscm_error_report("cscm_vm_compile_lambda", \
+				CSCM_ERROR_NULL_PTR);
+	else if (ef->type != CSCM_EF_TYPE_LAMBDA)
+		cscm_error_report("cscm_vm_compile_lambda", \
+				CSCM_ERROR_EF_TYPE);
+
+
+	s = (CSCM_LAMBDA_EF_STATE *)ef->state;
+
+	if (s->body->type != CSCM_EF_TYPE_VM)
+		s->body = cscm_vm_ef_construct(cscm_vm_compile(s->body), \
+						s->body);
+}